@@ -0,0 +1,203 @@
+#include "audio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// How long the audio thread sleeps when it has nothing to do
+const std::chrono::milliseconds AUDIO_IDLE_TIME(2);
+
+
+AudioSystem::AudioSystem(AudioBackend* backend)
+    : backend(backend), stats(), running(false), music(0), musicSound(0)
+{
+
+}
+
+AudioSystem::~AudioSystem()
+{
+    if (this->running)
+    {   // let the audio thread finish what it was told, then stop it
+        for (this->sendBacklog(); !this->backlog.empty(); this->sendBacklog())
+            std::this_thread::sleep_for(AUDIO_IDLE_TIME);
+        this->running = false;
+        this->thread.join();
+    }
+    for (Sound& sound : this->sounds)
+        for (VoiceHandle voice : sound.Voices)
+            this->backend->StopVoice(voice);
+    this->backend->StopVoice(this->music);
+}
+
+SoundHandle AudioSystem::LoadSound(const char* file, float volume, unsigned int maxVoices)
+{
+    return this->addSound(this->backend->LoadSound(file, false), volume, maxVoices);
+}
+
+SoundHandle AudioSystem::LoadMusic(const char* file, float volume)
+{
+    // music is long, so it is streamed while it plays instead
+    return this->addSound(this->backend->LoadSound(file, true), volume, 1);
+}
+
+SoundHandle AudioSystem::addSound(int sample, float volume, unsigned int maxVoices)
+{
+    Sound sound;
+    sound.Sample = sample;
+    sound.Volume = volume;
+    sound.MaxVoices = std::max(maxVoices, 1u);
+    sound.Requests = 0;
+    sound.Pan = 0.0f;
+    this->sounds.push_back(sound);
+    return static_cast<SoundHandle>(this->sounds.size() - 1);
+}
+
+void AudioSystem::Start()
+{
+    this->running = true;
+    this->thread = std::thread(&AudioSystem::run, this);
+}
+
+void AudioSystem::Play(SoundHandle sound, float pan)
+{
+    if (this->sounds[sound].Requests++ == 0)
+        this->requested.push_back(sound);
+    this->sounds[sound].Pan += pan;
+}
+
+void AudioSystem::PlayMusic(SoundHandle music)
+{
+    AudioCommand command = { AUDIO_PLAY_MUSIC, music, this->sounds[music].Volume, 0.0f, 0.0f };
+    this->send(command);
+}
+
+void AudioSystem::PrefetchMusic(SoundHandle music)
+{
+    AudioCommand command = { AUDIO_PREFETCH_MUSIC, music, 0.0f, 0.0f, 0.0f };
+    this->send(command);
+}
+
+void AudioSystem::StopMusic()
+{
+    AudioCommand command = { AUDIO_STOP_MUSIC, 0, 0.0f, 0.0f, 0.0f };
+    this->send(command);
+}
+
+void AudioSystem::Flush(float dt)
+{
+    for (SoundHandle handle : this->requested)
+    {
+        Sound& sound = this->sounds[handle];
+        // all requests of this frame play as one voice, louder the more there were, from where they were on average
+        float requests = static_cast<float>(sound.Requests);
+        AudioCommand command = { AUDIO_PLAY_SOUND, handle, std::min(sound.Volume * (1.0f + 0.25f * std::log2(requests)), 1.0f), sound.Pan / requests, 0.0f };
+        sound.Requests = 0;
+        sound.Pan = 0.0f;
+        this->send(command);
+    }
+    this->requested.clear();
+    AudioCommand advance = { AUDIO_ADVANCE, 0, 0.0f, 0.0f, dt };
+    this->send(advance);
+}
+
+void AudioSystem::send(const AudioCommand& command)
+{
+    if (!this->running)
+    {
+        this->execute(command); // no audio thread, run it right here
+        return;
+    }
+    if (command.Type == AUDIO_PLAY_SOUND)
+    {   // a late sound is worse than none, and it must not take the room kept for the other commands
+        if (!this->backlog.empty() || this->commands.Size() + AUDIO_RESERVED_COMMANDS >= AUDIO_QUEUE_SIZE || !this->commands.TryPush(command))
+            ++this->stats.SoundsDropped;
+        return;
+    }
+    // everything else has to arrive, in order: what doesn't fit waits for the next send
+    this->sendBacklog();
+    if (this->backlog.empty() && this->commands.TryPush(command))
+        return;
+    ++this->stats.CommandsDeferred;
+    if (command.Type == AUDIO_ADVANCE && !this->backlog.empty() && this->backlog.back().Type == AUDIO_ADVANCE)
+        this->backlog.back().Seconds += command.Seconds; // the mixer catches up in one go
+    else
+        this->backlog.push_back(command);
+}
+
+void AudioSystem::sendBacklog()
+{
+    while (!this->backlog.empty() && this->commands.TryPush(this->backlog.front()))
+        this->backlog.pop_front();
+}
+
+void AudioSystem::run()
+{
+    AudioCommand command;
+    for (;;)
+    {
+        bool stopping = !this->running;
+        while (this->commands.TryPop(command))
+            this->execute(command);
+        if (stopping)
+            break;
+        std::this_thread::sleep_for(AUDIO_IDLE_TIME);
+    }
+}
+
+void AudioSystem::execute(const AudioCommand& command)
+{
+    switch (command.Type)
+    {
+    case AUDIO_PLAY_SOUND:
+        this->playSound(command.Sound, command.Volume, command.Pan);
+        break;
+    case AUDIO_PLAY_MUSIC:
+        if (this->music && this->musicSound == command.Sound && this->backend->IsPlaying(this->music))
+            break; // already playing
+        {   // start the new track before stopping the old one, so there is no gap between them
+            VoiceHandle next = this->backend->StartVoice(this->sounds[command.Sound].Sample, command.Volume, 0.0f, true);
+            this->backend->StopVoice(this->music);
+            this->music = next;
+            this->musicSound = command.Sound;
+        }
+        break;
+    case AUDIO_PREFETCH_MUSIC:
+        if (!this->music || this->musicSound != command.Sound)
+            this->backend->Prefetch(this->sounds[command.Sound].Sample);
+        break;
+    case AUDIO_STOP_MUSIC:
+        this->backend->StopVoice(this->music);
+        this->music = 0;
+        break;
+    case AUDIO_ADVANCE:
+        this->backend->Advance(command.Seconds);
+        break;
+    }
+}
+
+void AudioSystem::playSound(SoundHandle handle, float volume, float pan)
+{
+    Sound& sound = this->sounds[handle];
+    if (sound.Sample < 0)
+        return;
+    // let go of the voices that have finished
+    for (unsigned int i = 0; i < sound.Voices.size();)
+    {
+        if (!this->backend->IsPlaying(sound.Voices[i]))
+        {
+            this->backend->StopVoice(sound.Voices[i]);
+            sound.Voices.erase(sound.Voices.begin() + i);
+        }
+        else
+            ++i;
+    }
+    // out of voices: steal the oldest one
+    if (sound.Voices.size() >= sound.MaxVoices)
+    {
+        this->backend->StopVoice(sound.Voices.front());
+        sound.Voices.erase(sound.Voices.begin());
+    }
+    VoiceHandle voice = this->backend->StartVoice(sound.Sample, volume, pan, false);
+    if (voice)
+        sound.Voices.push_back(voice);
+}
\ No newline at end of file
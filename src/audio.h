@@ -0,0 +1,111 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "audio_backend.h"
+#include "spsc_ring.h"
+
+
+// Refers to a sound loaded by AudioSystem::LoadSound or LoadMusic
+typedef unsigned int SoundHandle;
+
+// Number of copies of one sound effect that may play at once (unless given otherwise)
+const unsigned int DEFAULT_MAX_VOICES = 4;
+// Number of audio commands that can be waiting for the audio thread
+const unsigned int AUDIO_QUEUE_SIZE = 256;
+// Slots of the queue kept free for music and clock commands (sound effects don't take them)
+const unsigned int AUDIO_RESERVED_COMMANDS = 32;
+
+// What the game thread asks the audio thread to do
+enum AudioCommandType {
+    AUDIO_PLAY_SOUND,
+    AUDIO_PLAY_MUSIC,
+    AUDIO_PREFETCH_MUSIC,
+    AUDIO_STOP_MUSIC,
+    AUDIO_ADVANCE
+};
+
+struct AudioCommand {
+    AudioCommandType Type;
+    SoundHandle      Sound;
+    float            Volume;
+    float            Pan;
+    float            Seconds; // game time that passed (AUDIO_ADVANCE)
+};
+
+// What the command queue had to cope with (game thread counters)
+struct AudioStats {
+    unsigned long long SoundsDropped;    // sound effects not played because the queue was (nearly) full
+    unsigned long long CommandsDeferred; // music and clock commands that had to wait for room in the queue
+};
+
+// AudioSystem plays the sound effects and music on an AudioBackend. Sounds are
+// loaded up front and afterwards referred to by handle. Requests for the same sound
+// during one frame are merged into a single, louder voice, and each sound has a cap
+// on how many voices it uses: once that is reached its oldest voice is stopped to
+// make room. Once started, only the audio thread talks to the backend; the game
+// thread hands it commands through a lock-free ring, so a slow backend never holds
+// up a frame. If the ring fills up, sound effects are dropped rather than waited for;
+// music and clock commands always get through (they wait their turn on the game
+// thread, and the game time of waiting clock commands is added up).
+// Without Start, commands run right away on the calling thread.
+class AudioSystem
+{
+public:
+    // constructor/destructor; the backend has to outlive the AudioSystem
+    explicit AudioSystem(AudioBackend* backend);
+    ~AudioSystem();
+    // loads and decodes a sound effect; volume is that of a single request
+    SoundHandle LoadSound(const char* file, float volume = 1.0f, unsigned int maxVoices = DEFAULT_MAX_VOICES);
+    // registers a (streamed) music track
+    SoundHandle LoadMusic(const char* file, float volume = 1.0f);
+    // starts the audio thread; load everything before
+    void        Start();
+    // game thread: asks for a sound effect to be played at the next Flush; pan goes from -1 (left) to 1 (right)
+    void        Play(SoundHandle sound, float pan = 0.0f);
+    // game thread: loops the given track, or stops the music. A new track takes over right
+    // where the one playing leaves off; asking for the one playing lets it go on
+    void        PlayMusic(SoundHandle music);
+    // game thread: gets a track ready to be played next (e.g. that of the level about to start)
+    void        PrefetchMusic(SoundHandle music);
+    void        StopMusic();
+    // game thread: hands the sounds requested since the last Flush to the audio thread, along
+    // with the game time that passed (call once per frame)
+    void        Flush(float dt);
+    // game thread: how often the queue was full so far
+    const AudioStats& Stats() const { return this->stats; }
+private:
+    struct Sound {
+        int                      Sample; // backend sample id (-1 if it couldn't be loaded)
+        float                    Volume;
+        unsigned int             MaxVoices;
+        unsigned int             Requests; // since the last Flush (game thread)
+        float                    Pan;      // sum over the requests (game thread)
+        std::vector<VoiceHandle> Voices;   // oldest first (audio thread)
+    };
+    AudioBackend*            backend;
+    std::vector<Sound>       sounds;
+    std::vector<SoundHandle> requested; // sounds with Requests > 0, in order of their first request
+    std::deque<AudioCommand> backlog;   // music and clock commands that didn't fit in the ring yet, in order
+    AudioStats               stats;
+    // audio thread state
+    SpscRing<AudioCommand, AUDIO_QUEUE_SIZE> commands;
+    std::thread              thread;
+    std::atomic<bool>        running;
+    VoiceHandle              music;
+    SoundHandle              musicSound; // the track music plays
+    // game thread: queues a command
+    void send(const AudioCommand& command);
+    // game thread: moves as much of the backlog into the ring as fits
+    void sendBacklog();
+    SoundHandle addSound(int sample, float volume, unsigned int maxVoices);
+    // audio thread: runs commands until stopped
+    void run();
+    void execute(const AudioCommand& command);
+    void playSound(SoundHandle handle, float volume, float pan);
+};
+
+#endif
\ No newline at end of file
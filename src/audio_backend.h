@@ -0,0 +1,57 @@
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+
+// Refers to a playing voice; 0 is no voice
+typedef unsigned int VoiceHandle;
+
+// AudioBackend is what AudioSystem plays its sounds on (irrKlang, the software mixer,
+// or nothing at all). It is only ever called from one thread at a time.
+class AudioBackend
+{
+public:
+    virtual ~AudioBackend() { }
+    // loads a sound; music is streamed while it plays if the backend can. Returns the
+    // sample id voices are started with, or -1 if the file can't be played
+    virtual int         LoadSound(const char* file, bool stream) = 0;
+    // starts a voice; pan goes from -1 (left) to 1 (right). Returns 0 if it can't play
+    virtual VoiceHandle StartVoice(int sample, float volume, float pan, bool looped) = 0;
+    // gets a streamed sample ready to start without a gap, ahead of StartVoice (backends
+    // that stream on their own ignore this)
+    virtual void        Prefetch(int /*sample*/) { }
+    // whether a voice is still playing
+    virtual bool        IsPlaying(VoiceHandle voice) = 0;
+    // stops a voice (if still playing) and lets go of its handle
+    virtual void        StopVoice(VoiceHandle voice) = 0;
+    // tells the backend that seconds of game time have passed (backends that play in
+    // real time ignore this; the software mixer produces that much sound)
+    virtual void        Advance(float /*seconds*/) { }
+};
+
+// NullAudioBackend accepts every sound and plays none of them
+class NullAudioBackend : public AudioBackend
+{
+public:
+    int         LoadSound(const char* /*file*/, bool /*stream*/) { return 0; }
+    VoiceHandle StartVoice(int /*sample*/, float /*volume*/, float /*pan*/, bool /*looped*/) { return 0; }
+    bool        IsPlaying(VoiceHandle /*voice*/) { return false; }
+    void        StopVoice(VoiceHandle /*voice*/) { }
+};
+
+// AudioSink receives the mixed output of the software mixer
+class AudioSink
+{
+public:
+    virtual ~AudioSink() { }
+    // frames of interleaved 16-bit stereo
+    virtual void Write(const short* samples, unsigned int frames) = 0;
+};
+
+// NullSink throws the mixed sound away (the mixing itself still happens)
+class NullSink : public AudioSink
+{
+public:
+    void Write(const short* /*samples*/, unsigned int /*frames*/) { }
+};
+
+#endif
\ No newline at end of file
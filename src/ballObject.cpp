@@ -1,11 +1,24 @@
 #include "ballObject.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// pick the widest vector unit the compiler targets; everything else falls back to the scalar path
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BALL_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BALL_LANES 4
+#endif
+
 
 BallObject::BallObject()
     : GameObject(), Radius(12.5f), Stuck(true), Sticky(false), PassThrough(false) { }
 
-BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite)
-    : GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), sprite, glm::vec3(1.0f), velocity), Radius(radius), Stuck(true), Sticky(false), PassThrough(false) { }
+BallObject::BallObject(glm::vec2 pos, float radius, glm::vec2 velocity)
+    : GameObject(pos, glm::vec2(radius * 2.0f, radius * 2.0f), glm::vec3(1.0f), velocity), Radius(radius), Stuck(true), Sticky(false), PassThrough(false) { }
 
 glm::vec2 BallObject::Move(float dt, unsigned int window_width)
 {
@@ -38,8 +51,167 @@ glm::vec2 BallObject::Move(float dt, unsigned int window_width)
 void BallObject::Reset(glm::vec2 position, glm::vec2 velocity)
 {
     this->Position = position;
+    this->PreviousPosition = position;
     this->Velocity = velocity;
     this->Stuck = true;
     this->Sticky = false;
     this->PassThrough = false;
+}
+
+BallObject BallStore::Get(unsigned int i) const
+{
+    BallObject ball(this->Position(i), this->Radius[i], glm::vec2(this->VelocityX[i], this->VelocityY[i]));
+    ball.PreviousPosition = this->PreviousPosition(i);
+    ball.Color = this->Color[i];
+    ball.Stuck = (this->Flags[i] & BALL_STUCK) != 0;
+    ball.Sticky = (this->Flags[i] & BALL_STICKY) != 0;
+    ball.PassThrough = (this->Flags[i] & BALL_PASS_THROUGH) != 0;
+    return ball;
+}
+
+void BallStore::Set(unsigned int i, const BallObject& ball)
+{
+    this->X[i] = ball.Position.x; this->Y[i] = ball.Position.y;
+    this->PreviousX[i] = ball.PreviousPosition.x; this->PreviousY[i] = ball.PreviousPosition.y;
+    this->VelocityX[i] = ball.Velocity.x; this->VelocityY[i] = ball.Velocity.y;
+    this->Radius[i] = ball.Radius;
+    this->Color[i] = ball.Color;
+    this->Flags[i] = (ball.Stuck ? BALL_STUCK : 0) | (ball.Sticky ? BALL_STICKY : 0) | (ball.PassThrough ? BALL_PASS_THROUGH : 0);
+}
+
+#if BALL_LANES == 8
+// moves BALL_LANES balls starting at index i; returns the mask of moving balls that left the open band (and were not moved)
+static int moveLanes(BallStore& balls, unsigned int i, float dt, float width, float minY, float maxY)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps();
+    __m256 x = _mm256_loadu_ps(&balls.X[i]), y = _mm256_loadu_ps(&balls.Y[i]);
+    __m256 vx = _mm256_loadu_ps(&balls.VelocityX[i]), vy = _mm256_loadu_ps(&balls.VelocityY[i]);
+    __m256 size = _mm256_mul_ps(_mm256_loadu_ps(&balls.Radius[i]), _mm256_set1_ps(2.0f));
+    __m256i flags = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&balls.Flags[i])));
+    __m256i stuckBit = _mm256_set1_epi32(BALL_STUCK);
+    __m256 stuckMask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(flags, stuckBit), stuckBit));
+    int stuck = _mm256_movemask_ps(stuckMask);
+    // integrate, then see if the ball stayed clear of bricks and paddle the whole step
+    __m256 nx = _mm256_add_ps(x, _mm256_mul_ps(vx, _mm256_set1_ps(dt)));
+    __m256 ny = _mm256_add_ps(y, _mm256_mul_ps(vy, _mm256_set1_ps(dt)));
+    __m256 inBand = _mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(y, ny), _mm256_set1_ps(minY), _CMP_GT_OQ),
+        _mm256_cmp_ps(_mm256_add_ps(_mm256_max_ps(y, ny), size), _mm256_set1_ps(maxY), _CMP_LT_OQ));
+    int free = _mm256_movemask_ps(inBand) & ~stuck;
+    if (free != 0)
+    {
+        // bounce off the walls, as in BallObject::Move
+        __m256 left = _mm256_cmp_ps(nx, zero, _CMP_LE_OQ);
+        __m256 right = _mm256_andnot_ps(left, _mm256_cmp_ps(_mm256_add_ps(nx, size), _mm256_set1_ps(width), _CMP_GE_OQ));
+        __m256 top = _mm256_cmp_ps(ny, zero, _CMP_LE_OQ);
+        __m256 nvx = _mm256_xor_ps(vx, _mm256_and_ps(_mm256_or_ps(left, right), sign));
+        nx = _mm256_blendv_ps(_mm256_blendv_ps(nx, _mm256_sub_ps(_mm256_set1_ps(width), size), right), zero, left);
+        __m256 nvy = _mm256_xor_ps(vy, _mm256_and_ps(top, sign));
+        ny = _mm256_blendv_ps(ny, zero, top);
+        // only the free balls take the new state
+        __m256 mask = _mm256_andnot_ps(stuckMask, inBand);
+        _mm256_storeu_ps(&balls.X[i], _mm256_blendv_ps(x, nx, mask));
+        _mm256_storeu_ps(&balls.Y[i], _mm256_blendv_ps(y, ny, mask));
+        _mm256_storeu_ps(&balls.VelocityX[i], _mm256_blendv_ps(vx, nvx, mask));
+        _mm256_storeu_ps(&balls.VelocityY[i], _mm256_blendv_ps(vy, nvy, mask));
+    }
+    return ~(free | stuck) & 0xFF;
+}
+#elif BALL_LANES == 4
+static inline __m128 blend(__m128 a, __m128 b, __m128 mask)
+{
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// moves BALL_LANES balls starting at index i; returns the mask of moving balls that left the open band (and were not moved)
+static int moveLanes(BallStore& balls, unsigned int i, float dt, float width, float minY, float maxY)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f), zero = _mm_setzero_ps();
+    __m128 x = _mm_loadu_ps(&balls.X[i]), y = _mm_loadu_ps(&balls.Y[i]);
+    __m128 vx = _mm_loadu_ps(&balls.VelocityX[i]), vy = _mm_loadu_ps(&balls.VelocityY[i]);
+    __m128 size = _mm_mul_ps(_mm_loadu_ps(&balls.Radius[i]), _mm_set1_ps(2.0f));
+    int bytes;
+    std::memcpy(&bytes, &balls.Flags[i], sizeof(bytes));
+    __m128i flags = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), _mm_setzero_si128()), _mm_setzero_si128());
+    __m128i stuckBit = _mm_set1_epi32(BALL_STUCK);
+    __m128 stuckMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, stuckBit), stuckBit));
+    int stuck = _mm_movemask_ps(stuckMask);
+    // integrate, then see if the ball stayed clear of bricks and paddle the whole step
+    __m128 nx = _mm_add_ps(x, _mm_mul_ps(vx, _mm_set1_ps(dt)));
+    __m128 ny = _mm_add_ps(y, _mm_mul_ps(vy, _mm_set1_ps(dt)));
+    __m128 inBand = _mm_and_ps(_mm_cmpgt_ps(_mm_min_ps(y, ny), _mm_set1_ps(minY)),
+        _mm_cmplt_ps(_mm_add_ps(_mm_max_ps(y, ny), size), _mm_set1_ps(maxY)));
+    int free = _mm_movemask_ps(inBand) & ~stuck;
+    if (free != 0)
+    {
+        // bounce off the walls, as in BallObject::Move
+        __m128 left = _mm_cmple_ps(nx, zero);
+        __m128 right = _mm_andnot_ps(left, _mm_cmpge_ps(_mm_add_ps(nx, size), _mm_set1_ps(width)));
+        __m128 top = _mm_cmple_ps(ny, zero);
+        __m128 nvx = _mm_xor_ps(vx, _mm_and_ps(_mm_or_ps(left, right), sign));
+        nx = blend(blend(nx, _mm_sub_ps(_mm_set1_ps(width), size), right), zero, left);
+        __m128 nvy = _mm_xor_ps(vy, _mm_and_ps(top, sign));
+        ny = blend(ny, zero, top);
+        // only the free balls take the new state
+        __m128 mask = _mm_andnot_ps(stuckMask, inBand);
+        _mm_storeu_ps(&balls.X[i], blend(x, nx, mask));
+        _mm_storeu_ps(&balls.Y[i], blend(y, ny, mask));
+        _mm_storeu_ps(&balls.VelocityX[i], blend(vx, nvx, mask));
+        _mm_storeu_ps(&balls.VelocityY[i], blend(vy, nvy, mask));
+    }
+    return ~(free | stuck) & 0xF;
+}
+#endif
+
+void MoveBalls(BallStore& balls, unsigned int first, unsigned int last, float dt, unsigned int window_width, float minY, float maxY, std::vector<unsigned int>& rest)
+{
+    float width = static_cast<float>(window_width);
+#ifndef NDEBUG
+    std::vector<BallObject> before;
+    for (unsigned int j = first; j < last; ++j)
+        before.push_back(balls.Get(j));
+    size_t restBegin = rest.size();
+#endif
+    unsigned int i = first;
+#ifdef BALL_LANES
+    for (; i + BALL_LANES <= last; i += BALL_LANES)
+    {
+        int mask = moveLanes(balls, i, dt, width, minY, maxY);
+        for (unsigned int lane = 0; mask != 0; ++lane, mask >>= 1)
+            if (mask & 1)
+                rest.push_back(i + lane);
+    }
+#endif
+    // remaining balls (or all of them without vector support) go one at a time
+    for (; i < last; ++i)
+    {
+        if (balls.IsStuck(i))
+            continue;
+        float size = balls.Radius[i] * 2.0f;
+        float y = balls.Y[i] + balls.VelocityY[i] * dt;
+        if (std::min(balls.Y[i], y) <= minY || std::max(balls.Y[i], y) + size >= maxY)
+        {
+            rest.push_back(i);
+            continue;
+        }
+        BallObject ball = balls.Get(i);
+        ball.Move(dt, window_width);
+        balls.Set(i, ball);
+    }
+#ifndef NDEBUG
+    // debug builds verify the vectorized results against BallObject::Move
+    size_t next = restBegin;
+    for (unsigned int j = first; j < last; ++j)
+    {
+        if (next < rest.size() && rest[next] == j)
+        {
+            ++next;
+            continue;
+        }
+        BallObject& ball = before[j - first];
+        ball.Move(dt, window_width);
+        assert(balls.Position(j) == ball.Position);
+        assert(balls.VelocityX[j] == ball.Velocity.x && balls.VelocityY[j] == ball.Velocity.y);
+    }
+    assert(next == rest.size());
+#endif
 }
\ No newline at end of file
@@ -1,11 +1,10 @@
 #ifndef BALLOBJECT_H
 #define BALLOBJECT_H
+#include <vector>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "game_object.h"
-#include "texture.h"
 
 
 // BallObject holds the state of the Ball object inheriting
@@ -21,11 +20,73 @@ public:
     bool    Sticky, PassThrough;
     // constructor(s)
     BallObject();
-    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite);
+    BallObject(glm::vec2 pos, float radius, glm::vec2 velocity);
     // moves the ball, keeping it constrained within the window bounds (except bottom edge); returns new position
     glm::vec2 Move(float dt, unsigned int window_width);
     // resets the ball to original state with given position and velocity
     void      Reset(glm::vec2 position, glm::vec2 velocity);
 };
 
+// Per-ball state bits packed into BallStore::Flags
+enum BallFlags : unsigned char {
+    BALL_STUCK        = 1 << 0,
+    BALL_STICKY       = 1 << 1,
+    BALL_PASS_THROUGH = 1 << 2
+};
+
+// BallStore keeps all balls in play as parallel arrays (structure of arrays) so the
+// common case - a ball flying through open space - can be moved many balls at a time.
+// Balls are removed by swapping the last one into their slot, so their order is not stable.
+struct BallStore {
+    std::vector<float>         X, Y;                  // top-left corner
+    std::vector<float>         PreviousX, PreviousY;  // position at the start of the current simulation step
+    std::vector<float>         VelocityX, VelocityY;
+    std::vector<float>         Radius;
+    std::vector<glm::vec3>     Color;
+    std::vector<unsigned char> Flags;                 // BallFlags
+
+    unsigned int Count() const { return static_cast<unsigned int>(this->X.size()); }
+    bool         Empty() const { return this->X.empty(); }
+    glm::vec2    Position(unsigned int i) const { return glm::vec2(this->X[i], this->Y[i]); }
+    glm::vec2    PreviousPosition(unsigned int i) const { return glm::vec2(this->PreviousX[i], this->PreviousY[i]); }
+    glm::vec2    Size(unsigned int i) const { return glm::vec2(this->Radius[i] * 2.0f); }
+    bool         IsStuck(unsigned int i) const { return (this->Flags[i] & BALL_STUCK) != 0; }
+    void Clear()
+    {
+        X.clear(); Y.clear(); PreviousX.clear(); PreviousY.clear();
+        VelocityX.clear(); VelocityY.clear(); Radius.clear(); Color.clear(); Flags.clear();
+    }
+    // adds a ball (stuck to the paddle, like a new BallObject) and returns its index
+    unsigned int Add(glm::vec2 pos, float radius, glm::vec2 velocity, unsigned char flags = BALL_STUCK)
+    {
+        X.push_back(pos.x); Y.push_back(pos.y);
+        PreviousX.push_back(pos.x); PreviousY.push_back(pos.y);
+        VelocityX.push_back(velocity.x); VelocityY.push_back(velocity.y);
+        Radius.push_back(radius);
+        Color.push_back(glm::vec3(1.0f));
+        Flags.push_back(flags);
+        return this->Count() - 1;
+    }
+    // removes a ball by moving the last ball into its slot
+    void Remove(unsigned int i)
+    {
+        unsigned int last = this->Count() - 1;
+        X[i] = X[last]; Y[i] = Y[last];
+        PreviousX[i] = PreviousX[last]; PreviousY[i] = PreviousY[last];
+        VelocityX[i] = VelocityX[last]; VelocityY[i] = VelocityY[last];
+        Radius[i] = Radius[last]; Color[i] = Color[last]; Flags[i] = Flags[last];
+        X.pop_back(); Y.pop_back(); PreviousX.pop_back(); PreviousY.pop_back();
+        VelocityX.pop_back(); VelocityY.pop_back(); Radius.pop_back(); Color.pop_back(); Flags.pop_back();
+    }
+    // copies a ball out of (Get) and back into (Set) the store, for code that works on a single BallObject
+    BallObject Get(unsigned int i) const;
+    void       Set(unsigned int i, const BallObject& ball);
+};
+
+// moves every ball in [first, last) that isn't stuck and stays strictly between minY and maxY during the step (no
+// bricks or paddle in reach), bouncing off the side and top walls exactly like BallObject::Move, several balls at a
+// time (SSE2/AVX2 where available). The indices of all other moving balls are appended to rest, in ascending order.
+// Only touches the balls in the range, so disjoint ranges can be moved on different threads.
+void MoveBalls(BallStore& balls, unsigned int first, unsigned int last, float dt, unsigned int window_width, float minY, float maxY, std::vector<unsigned int>& rest);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "collision.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// pick the widest vector unit the compiler targets; everything else falls back to the scalar path
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_LANES 4
+#endif
+
+
+bool CheckCollision(GameObject& one, GameObject& two) // AABB - AABB collision
+{
+    return CheckCollision(one.Position, one.Size, two.Position, two.Size);
+}
+
+bool CheckCollision(glm::vec2 onePosition, glm::vec2 oneSize, glm::vec2 twoPosition, glm::vec2 twoSize)
+{
+    // collision x-axis?
+    bool collisionX = onePosition.x + oneSize.x >= twoPosition.x &&
+        twoPosition.x + twoSize.x >= onePosition.x;
+    // collision y-axis?
+    bool collisionY = onePosition.y + oneSize.y >= twoPosition.y &&
+        twoPosition.y + twoSize.y >= onePosition.y;
+    // collision only if on both axes
+    return collisionX && collisionY;
+}
+
+Collision CheckCollision(BallObject& one, GameObject& two) // AABB - Circle collision
+{
+    return CheckCollision(one, two.Position, two.Size);
+}
+
+Collision CheckCollision(BallObject& one, glm::vec2 position, glm::vec2 size) // AABB - Circle collision
+{
+    // get center point circle first
+    return CheckCollision(one.Position + one.Radius, one.Radius, position, size);
+}
+
+Collision CheckCollision(glm::vec2 center, float radius, glm::vec2 position, glm::vec2 size) // AABB - Circle collision
+{
+    // calculate AABB info (center, half-extents)
+    glm::vec2 aabb_half_extents(size.x / 2.0f, size.y / 2.0f);
+    glm::vec2 aabb_center(position.x + aabb_half_extents.x, position.y + aabb_half_extents.y);
+    // get difference vector between both centers
+    glm::vec2 difference = center - aabb_center;
+    glm::vec2 clamped = glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
+    // now that we know the clamped values, add this to AABB_center and we get the value of box closest to circle
+    glm::vec2 closest = aabb_center + clamped;
+    // now retrieve vector between center circle and closest point AABB and check if length < radius (squared, to skip the square root)
+    difference = closest - center;
+
+    if (difference.x * difference.x + difference.y * difference.y < radius * radius) // not <= since in that case a collision also occurs when object one exactly touches object two, which they are at the end of each collision resolution stage.
+        return std::make_tuple(true, VectorDirection(difference), difference);
+    else
+        return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
+}
+
+Direction VectorDirection(glm::vec2 target)
+{
+    // the dot products with the compass directions (up, right, down, left) are just the signed
+    // components of target; normalizing first would not change which one is the largest.
+    // A zero vector has no best match and is treated as a downward hit.
+    float max = 0.0f;
+    Direction best_match = DOWN;
+    if (target.y > max) { max = target.y;  best_match = UP; }
+    if (target.x > max) { max = target.x;  best_match = RIGHT; }
+    if (-target.y > max) { max = -target.y; best_match = DOWN; }
+    if (-target.x > max) { max = -target.x; best_match = LEFT; }
+    return best_match;
+}
+
+bool SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 delta, glm::vec2 position, glm::vec2 size, float& toi, glm::vec2& normal)
+{
+    // the circle touches the box exactly when its center enters the box grown by the radius with rounded
+    // corners, so first intersect the path of the center with the grown box (slab test)...
+    glm::vec2 boxMin = position - radius, boxMax = position + size + radius;
+    float tEnter = 0.0f, tExit = 1.0f;
+    glm::vec2 enterNormal(0.0f);
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        if (delta[axis] == 0.0f)
+        {
+            if (center[axis] < boxMin[axis] || center[axis] > boxMax[axis])
+                return false;
+            continue;
+        }
+        float t0 = (boxMin[axis] - center[axis]) / delta[axis];
+        float t1 = (boxMax[axis] - center[axis]) / delta[axis];
+        float side = -1.0f; // entering through the min side
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+            side = 1.0f;
+        }
+        if (t0 > tEnter)
+        {
+            tEnter = t0;
+            enterNormal = glm::vec2(0.0f);
+            enterNormal[axis] = side;
+        }
+        tExit = std::min(tExit, t1);
+        if (tEnter > tExit)
+            return false;
+    }
+    // ...then, if that entry point lies beyond both box edges, the path actually has to hit the rounded corner
+    glm::vec2 entry = center + delta * tEnter;
+    bool outsideX = entry.x < position.x || entry.x > position.x + size.x;
+    bool outsideY = entry.y < position.y || entry.y > position.y + size.y;
+    if (outsideX && outsideY)
+    {
+        glm::vec2 corner(entry.x < position.x ? position.x : position.x + size.x, entry.y < position.y ? position.y : position.y + size.y);
+        glm::vec2 m = center - corner;
+        float b = glm::dot(m, delta);
+        float c = glm::dot(m, m) - radius * radius;
+        if (c <= 0.0f || b >= 0.0f) // already touching the corner, or moving away from it
+            return false;
+        float a = glm::dot(delta, delta);
+        float discriminant = b * b - a * c;
+        if (discriminant < 0.0f)
+            return false;
+        float t = (-b - std::sqrt(discriminant)) / a;
+        if (t > 1.0f)
+            return false;
+        toi = t;
+        normal = glm::normalize(center + delta * t - corner);
+        return true;
+    }
+    if (enterNormal == glm::vec2(0.0f)) // the path starts inside
+        return false;
+    toi = tEnter;
+    normal = enterNormal;
+    return true;
+}
+
+#if COLLISION_LANES == 8
+// tests COLLISION_LANES boxes starting at index i; returns the hit mask and stores each lane's difference vector and direction
+static int collideLanes(const CollisionBatch& batch, unsigned int i, glm::vec2 center, float radius, float* diffX, float* diffY, float* dir)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps();
+    __m256 cx = _mm256_set1_ps(center.x), cy = _mm256_set1_ps(center.y);
+    __m256 hx = _mm256_mul_ps(_mm256_loadu_ps(&batch.Width[i]), _mm256_set1_ps(0.5f));
+    __m256 hy = _mm256_mul_ps(_mm256_loadu_ps(&batch.Height[i]), _mm256_set1_ps(0.5f));
+    __m256 ax = _mm256_add_ps(_mm256_loadu_ps(&batch.X[i]), hx);
+    __m256 ay = _mm256_add_ps(_mm256_loadu_ps(&batch.Y[i]), hy);
+    // clamp center difference to the half extents, then take the closest point relative to the circle center
+    __m256 dx = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(cx, ax), _mm256_xor_ps(hx, sign)), hx);
+    __m256 dy = _mm256_min_ps(_mm256_max_ps(_mm256_sub_ps(cy, ay), _mm256_xor_ps(hy, sign)), hy);
+    dx = _mm256_sub_ps(_mm256_add_ps(ax, dx), cx);
+    dy = _mm256_sub_ps(_mm256_add_ps(ay, dy), cy);
+    __m256 dist = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    int mask = _mm256_movemask_ps(_mm256_cmp_ps(dist, _mm256_set1_ps(radius * radius), _CMP_LT_OQ));
+    if (mask == 0)
+        return 0;
+    // same compass walk as VectorDirection, one lane per box
+    __m256 best = zero, d = _mm256_set1_ps(static_cast<float>(DOWN)), m, v;
+    m = _mm256_cmp_ps(dy, best, _CMP_GT_OQ); best = _mm256_blendv_ps(best, dy, m); d = _mm256_blendv_ps(d, _mm256_set1_ps(static_cast<float>(UP)), m);
+    m = _mm256_cmp_ps(dx, best, _CMP_GT_OQ); best = _mm256_blendv_ps(best, dx, m); d = _mm256_blendv_ps(d, _mm256_set1_ps(static_cast<float>(RIGHT)), m);
+    v = _mm256_xor_ps(dy, sign);
+    m = _mm256_cmp_ps(v, best, _CMP_GT_OQ); best = _mm256_blendv_ps(best, v, m); d = _mm256_blendv_ps(d, _mm256_set1_ps(static_cast<float>(DOWN)), m);
+    v = _mm256_xor_ps(dx, sign);
+    m = _mm256_cmp_ps(v, best, _CMP_GT_OQ); d = _mm256_blendv_ps(d, _mm256_set1_ps(static_cast<float>(LEFT)), m);
+    _mm256_storeu_ps(diffX, dx);
+    _mm256_storeu_ps(diffY, dy);
+    _mm256_storeu_ps(dir, d);
+    return mask;
+}
+#elif COLLISION_LANES == 4
+static inline __m128 blend(__m128 a, __m128 b, __m128 mask)
+{
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// tests COLLISION_LANES boxes starting at index i; returns the hit mask and stores each lane's difference vector and direction
+static int collideLanes(const CollisionBatch& batch, unsigned int i, glm::vec2 center, float radius, float* diffX, float* diffY, float* dir)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f), zero = _mm_setzero_ps();
+    __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y);
+    __m128 hx = _mm_mul_ps(_mm_loadu_ps(&batch.Width[i]), _mm_set1_ps(0.5f));
+    __m128 hy = _mm_mul_ps(_mm_loadu_ps(&batch.Height[i]), _mm_set1_ps(0.5f));
+    __m128 ax = _mm_add_ps(_mm_loadu_ps(&batch.X[i]), hx);
+    __m128 ay = _mm_add_ps(_mm_loadu_ps(&batch.Y[i]), hy);
+    // clamp center difference to the half extents, then take the closest point relative to the circle center
+    __m128 dx = _mm_min_ps(_mm_max_ps(_mm_sub_ps(cx, ax), _mm_xor_ps(hx, sign)), hx);
+    __m128 dy = _mm_min_ps(_mm_max_ps(_mm_sub_ps(cy, ay), _mm_xor_ps(hy, sign)), hy);
+    dx = _mm_sub_ps(_mm_add_ps(ax, dx), cx);
+    dy = _mm_sub_ps(_mm_add_ps(ay, dy), cy);
+    __m128 dist = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    int mask = _mm_movemask_ps(_mm_cmplt_ps(dist, _mm_set1_ps(radius * radius)));
+    if (mask == 0)
+        return 0;
+    // same compass walk as VectorDirection, one lane per box
+    __m128 best = zero, d = _mm_set1_ps(static_cast<float>(DOWN)), m, v;
+    m = _mm_cmpgt_ps(dy, best); best = blend(best, dy, m); d = blend(d, _mm_set1_ps(static_cast<float>(UP)), m);
+    m = _mm_cmpgt_ps(dx, best); best = blend(best, dx, m); d = blend(d, _mm_set1_ps(static_cast<float>(RIGHT)), m);
+    v = _mm_xor_ps(dy, sign);
+    m = _mm_cmpgt_ps(v, best); best = blend(best, v, m); d = blend(d, _mm_set1_ps(static_cast<float>(DOWN)), m);
+    v = _mm_xor_ps(dx, sign);
+    m = _mm_cmpgt_ps(v, best); d = blend(d, _mm_set1_ps(static_cast<float>(LEFT)), m);
+    _mm_storeu_ps(diffX, dx);
+    _mm_storeu_ps(diffY, dy);
+    _mm_storeu_ps(dir, d);
+    return mask;
+}
+#endif
+
+unsigned int CheckCollisionBatch(glm::vec2 center, float radius, CollisionBatch& batch, unsigned int first)
+{
+    unsigned int count = batch.Count();
+    if (batch.Hits.size() < count)
+        batch.Hits.resize(count);
+    unsigned int hits = 0;
+    unsigned int i = first;
+#ifdef COLLISION_LANES
+    float diffX[COLLISION_LANES], diffY[COLLISION_LANES], dir[COLLISION_LANES];
+    for (; i + COLLISION_LANES <= count; i += COLLISION_LANES)
+    {
+        int mask = collideLanes(batch, i, center, radius, diffX, diffY, dir);
+        for (unsigned int lane = 0; mask != 0; ++lane, mask >>= 1)
+        {
+            if (mask & 1)
+            {
+                CollisionHit& hit = batch.Hits[hits++];
+                hit.Index = i + lane;
+                hit.Dir = static_cast<Direction>(static_cast<int>(dir[lane]));
+                hit.Difference = glm::vec2(diffX[lane], diffY[lane]);
+            }
+        }
+    }
+#endif
+    // remaining boxes (or all of them without vector support) go through the scalar test
+    for (; i < count; ++i)
+    {
+        Collision collision = CheckCollision(center, radius, glm::vec2(batch.X[i], batch.Y[i]), glm::vec2(batch.Width[i], batch.Height[i]));
+        if (std::get<0>(collision))
+        {
+            CollisionHit& hit = batch.Hits[hits++];
+            hit.Index = i;
+            hit.Dir = std::get<1>(collision);
+            hit.Difference = std::get<2>(collision);
+        }
+    }
+#ifndef NDEBUG
+    // debug builds verify the vectorized results against the scalar test
+    unsigned int checked = 0;
+    for (unsigned int j = first; j < count; ++j)
+    {
+        Collision collision = CheckCollision(center, radius, glm::vec2(batch.X[j], batch.Y[j]), glm::vec2(batch.Width[j], batch.Height[j]));
+        if (std::get<0>(collision))
+        {
+            assert(checked < hits && batch.Hits[checked].Index == j);
+            assert(batch.Hits[checked].Dir == std::get<1>(collision));
+            assert(batch.Hits[checked].Difference == std::get<2>(collision));
+            ++checked;
+        }
+    }
+    assert(checked == hits);
+#endif
+    return hits;
+}
@@ -0,0 +1,67 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+#include <vector>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+#include "game_object.h"
+#include "ballObject.h"
+
+
+// Represents the four possible (collision) directions
+enum Direction {
+    UP,
+    RIGHT,
+    DOWN,
+    LEFT
+};
+// Defines a Collision typedef that represents collision data
+typedef std::tuple<bool, Direction, glm::vec2> Collision; // <collision?, what direction?, difference vector center - closest point>
+
+// A single hit reported by CheckCollisionBatch
+struct CollisionHit {
+    unsigned int Index;      // index of the box within the batch
+    Direction    Dir;        // what direction?
+    glm::vec2    Difference; // difference vector closest point - circle center
+};
+
+// CollisionBatch gathers candidate boxes into parallel arrays so a ball
+// can be tested against all of them at once by CheckCollisionBatch.
+struct CollisionBatch {
+    std::vector<unsigned int> Source;        // caller's id of each box (e.g. brick index)
+    std::vector<float>        X, Y, Width, Height;
+    std::vector<CollisionHit> Hits;          // output buffer, sized to the batch
+
+    unsigned int Count() const { return static_cast<unsigned int>(this->Source.size()); }
+    void Clear()
+    {
+        Source.clear(); X.clear(); Y.clear(); Width.clear(); Height.clear();
+    }
+    void Add(unsigned int source, float x, float y, float width, float height)
+    {
+        Source.push_back(source);
+        X.push_back(x); Y.push_back(y);
+        Width.push_back(width); Height.push_back(height);
+    }
+};
+
+// AABB - AABB collision
+bool      CheckCollision(GameObject& one, GameObject& two);
+bool      CheckCollision(glm::vec2 onePosition, glm::vec2 oneSize, glm::vec2 twoPosition, glm::vec2 twoSize);
+// AABB - Circle collision
+Collision CheckCollision(BallObject& one, GameObject& two);
+Collision CheckCollision(BallObject& one, glm::vec2 position, glm::vec2 size);
+Collision CheckCollision(glm::vec2 center, float radius, glm::vec2 position, glm::vec2 size);
+// tests a circle against the boxes [first, count) of a batch at once (SSE2/AVX where available) and
+// stores every hit in batch.Hits (in box order, Index relative to the batch); returns the number of hits.
+// Gives exactly the same results as calling the scalar CheckCollision on each box.
+unsigned int CheckCollisionBatch(glm::vec2 center, float radius, CollisionBatch& batch, unsigned int first = 0);
+// sweeps a circle moving by delta against an AABB; returns true if it touches the box during the move and gives the
+// time of impact (as a fraction of delta) and the contact normal (pointing out of the box). Circles that already
+// overlap the box at the start of the move are left to the discrete CheckCollision.
+bool      SweepCircleAABB(glm::vec2 center, float radius, glm::vec2 delta, glm::vec2 position, glm::vec2 size, float& toi, glm::vec2& normal);
+// returns the compass direction closest to the given (non normalized) vector
+Direction VectorDirection(glm::vec2 target);
+
+#endif
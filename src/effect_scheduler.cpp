@@ -0,0 +1,47 @@
+#include "effect_scheduler.h"
+
+#include <algorithm>
+
+
+EffectScheduler::EffectScheduler(unsigned int count)
+    : references(count, 0), now(0.0), sequence(0)
+{
+
+}
+
+void EffectScheduler::Start(unsigned int effect, float duration)
+{
+    Timer timer;
+    timer.Expiry = this->now + duration;
+    timer.Sequence = this->sequence++;
+    timer.Effect = effect;
+    this->timers.push_back(timer);
+    std::push_heap(this->timers.begin(), this->timers.end(), later);
+    ++this->references[effect];
+}
+
+void EffectScheduler::Advance(float dt, std::vector<unsigned int>& expired)
+{
+    this->now += dt;
+    while (!this->timers.empty() && this->timers.front().Expiry <= this->now)
+    {
+        unsigned int effect = this->timers.front().Effect;
+        std::pop_heap(this->timers.begin(), this->timers.end(), later);
+        this->timers.pop_back();
+        if (--this->references[effect] == 0)
+            expired.push_back(effect);
+    }
+}
+
+void EffectScheduler::Clear()
+{
+    this->timers.clear();
+    std::fill(this->references.begin(), this->references.end(), 0);
+    this->now = 0.0;
+    this->sequence = 0;
+}
+
+bool EffectScheduler::later(const Timer& a, const Timer& b)
+{
+    return a.Expiry > b.Expiry || (a.Expiry == b.Expiry && a.Sequence > b.Sequence);
+}
\ No newline at end of file
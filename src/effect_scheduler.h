@@ -0,0 +1,42 @@
+#ifndef EFFECT_SCHEDULER_H
+#define EFFECT_SCHEDULER_H
+#include <vector>
+
+
+// EffectScheduler keeps track of timed effects (power-ups, screen shake). Every Start
+// holds a reference on an effect until its time runs out, so an effect picked up
+// several times stays active until the last pickup expires. Timers are kept in a
+// min-heap on their expiry time, so Advance only touches the timers that expire.
+class EffectScheduler
+{
+public:
+    // constructor; effects are numbered [0, count)
+    explicit EffectScheduler(unsigned int count);
+    // starts a timer on effect that runs out after duration seconds
+    void Start(unsigned int effect, float duration);
+    // whether any timer of effect is running
+    bool IsActive(unsigned int effect) const { return this->references[effect] > 0; }
+    // number of timers of effect that are running
+    unsigned int References(unsigned int effect) const { return this->references[effect]; }
+    // moves the clock forward by dt and appends every effect whose last timer ran out to expired
+    // (in the order they ran out)
+    void Advance(float dt, std::vector<unsigned int>& expired);
+    // stops every timer without reporting anything
+    void Clear();
+    // time since the scheduler was created (or cleared)
+    double Now() const { return this->now; }
+private:
+    struct Timer {
+        double             Expiry;
+        unsigned long long Sequence; // breaks ties so timers that run out together do so in start order
+        unsigned int       Effect;
+    };
+    // heap order: the timer that runs out first ends up at the front
+    static bool later(const Timer& a, const Timer& b);
+    std::vector<Timer>        timers;
+    std::vector<unsigned int> references;
+    double                    now;
+    unsigned long long        sequence;
+};
+
+#endif
\ No newline at end of file
@@ -6,81 +6,32 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include "game_level.h"
-#include "power_up.h"
-#include "ballObject.h"
+#include "simulation.h"
 
-// Represents the current state of the game
-enum GameState {
-    GAME_ACTIVE,
-    GAME_MENU,
-    GAME_WIN
-};
-
-// Represents the four possible (collision) directions
-enum Direction {
-    UP,
-    RIGHT,
-    DOWN,
-    LEFT
-};
-// Defines a Collision typedef that represents collision data
-typedef std::tuple<bool, Direction, glm::vec2> Collision; // <collision?, what direction?, difference vector center - closest point>
-
-// Initial size of the player paddle
-const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
-// Initial velocity of the player paddle
-const float PLAYER_VELOCITY(500.0f);
-// Initial velocity of the Ball
-const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
-// Radius of the ball object
-const float BALL_RADIUS = 12.5f;
-
-//the numbers of blocks destroyed for extra life
-const int BLOCK_COUNT_LIFES = 10;
-
-//the start countdown
-const float COUNTDOWN_START = 180;
-// Game holds all game-related state and functionality.
-// Combines all game-related data into a single class for
-// easy access to each of the components and manageability.
-class Game
+// Game is the windowed front end of the simulation: it turns keyboard
+// state into simulation input, draws the simulation state and plays
+// sounds for the events the simulation raises.
+class Game : public SimulationListener
 {
 public:
     // game state
-    GameState               State;
+    Simulation              World;
     bool                    Keys[1024];
     bool                    KeysProcessed[1024];
-
-    //extra Power up
-    bool                    Split;
-
-    float                   Countdown;
     unsigned int            Width, Height;
-    std::vector<GameLevel>  Levels;
-    std::vector<PowerUp>    PowerUps;
-    std::vector<BallObject> Balls; // To manage the balls
-    unsigned int            Level;
-    unsigned int            Lives;
     // constructor/destructor
     Game(unsigned int width, unsigned int height);
     ~Game();
     // initialize game state (load all shaders/textures/levels)
     void Init();
-    // game loop
+    // game loop; ProcessInput and Update advance the simulation by one fixed step, after BeginStep
+    // remembered where everything was so Render can interpolate between the last two steps
+    void BeginStep();
     void ProcessInput(float dt);
     void Update(float dt);
-    void Render();
-    void DoCollisions();
-    // reset
-    void ResetLevel();
-    void ResetPlayer();
-
-    void SpawnPowerUps(GameObject& block);
-    void UpdatePowerUps(float dt);
-     void ActivatePowerUp(PowerUp& powerUp); 
-private:
-    unsigned int ExtraLifeCounter;
+    void Render(float alpha = 1.0f);
+    // plays the sound of each simulation event
+    void OnSimulationEvent(const SimulationEvent& event);
 };
 
 #endif
\ No newline at end of file
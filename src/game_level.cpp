@@ -1,85 +1,126 @@
 #include "game_level.h"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
 
+#include "level_format.h"
+#include "mapped_file.h"
+
+
+const glm::vec3 GameLevel::Palette[6] = {
+    glm::vec3(1.0f),                // original: white
+    glm::vec3(0.8f, 0.8f, 0.7f),    // solid
+    glm::vec3(0.2f, 0.6f, 1.0f),
+    glm::vec3(0.0f, 0.7f, 0.0f),
+    glm::vec3(0.8f, 0.8f, 0.4f),
+    glm::vec3(1.0f, 0.5f, 0.0f)
+};
 
 void GameLevel::Load(const char* file, unsigned int levelWidth, unsigned int levelHeight)
 {
     // clear old data
-    this->Bricks.clear();
-    // load from file
-    unsigned int tileCode;
-    GameLevel level;
-    std::string line;
-    std::ifstream fstream(file);
-    std::vector<std::vector<unsigned int>> tileData;
-    if (fstream)
+    this->Bricks.Clear();
+    this->BreakableLeft = 0;
+    this->Cells.clear();
+    this->GridWidth = this->GridHeight = 0;
+    // load from file: mapped, so the tiles are read straight out of the page cache
+    MappedFile mapped;
+    if (!mapped.Open(file))
+        return;
+    if (IsCompiledLevel(mapped.Data(), mapped.Size()))
     {
-        while (std::getline(fstream, line)) // read each line from level file
-        {
-            std::istringstream sstream(line);
-            std::vector<unsigned int> row;
-            while (sstream >> tileCode) // read each word separated by spaces
-                row.push_back(tileCode);
-            tileData.push_back(row);
-        }
-        if (tileData.size() > 0)
-            this->init(tileData, levelWidth, levelHeight);
+        unsigned int width, height;
+        const unsigned char* codes;
+        if (ReadCompiledLevel(mapped.Data(), mapped.Size(), width, height, codes) && width > 0 && height > 0)
+            this->init(codes, width, height, levelWidth, levelHeight);
+        return;
     }
+    LevelTiles tiles;
+    ParseLevelText(reinterpret_cast<const char*>(mapped.Data()), mapped.Size(), tiles);
+    if (tiles.Height > 0)
+        this->init(&tiles.Codes[0], tiles.Width, tiles.Height, levelWidth, levelHeight);
+}
+
+void GameLevel::Reset(const GameLevel& pristine)
+{
+    assert(pristine.Bricks.Count() == this->Bricks.Count());
+    std::copy(pristine.Bricks.Flags.begin(), pristine.Bricks.Flags.end(), this->Bricks.Flags.begin());
+    this->BreakableLeft = pristine.BreakableLeft;
 }
 
-void GameLevel::Draw(SpriteRenderer& renderer)
+void GameLevel::DestroyBrick(unsigned int index)
 {
-    for (GameObject& tile : this->Bricks)
-        if (!tile.Destroyed)
-            tile.Draw(renderer);
+    if (this->Bricks.IsDestroyed(index))
+        return;
+    this->Bricks.Flags[index] |= BRICK_DESTROYED;
+    if (!this->Bricks.IsSolid(index))
+        --this->BreakableLeft;
 }
 
-bool GameLevel::IsCompleted()
+void GameLevel::QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<unsigned int>& result) const
 {
-    for (GameObject& tile : this->Bricks)
-        if (!tile.IsSolid && !tile.Destroyed)
-            return false;
-    return true;
+    result.clear();
+    if (this->GridWidth == 0 || this->GridHeight == 0)
+        return;
+    // convert the box to an inclusive range of lattice cells, clamped to the grid
+    float x0 = std::floor(min.x / this->UnitWidth), x1 = std::floor(max.x / this->UnitWidth);
+    float y0 = std::floor(min.y / this->UnitHeight), y1 = std::floor(max.y / this->UnitHeight);
+    if (x1 < 0.0f || y1 < 0.0f || x0 >= this->GridWidth || y0 >= this->GridHeight)
+        return;
+    // clamp before converting, so boxes far outside the grid never overflow an unsigned int
+    unsigned int minX = static_cast<unsigned int>(std::max(x0, 0.0f)), maxX = static_cast<unsigned int>(std::min(x1, this->GridWidth - 1.0f));
+    unsigned int minY = static_cast<unsigned int>(std::max(y0, 0.0f)), maxY = static_cast<unsigned int>(std::min(y1, this->GridHeight - 1.0f));
+    // cells are visited row-major, which matches the order the bricks were created in
+    for (unsigned int y = minY; y <= maxY; ++y)
+    {
+        for (unsigned int x = minX; x <= maxX; ++x)
+        {
+            int brick = this->Cells[y * this->GridWidth + x];
+            if (brick >= 0)
+                result.push_back(brick);
+        }
+    }
 }
 
-void GameLevel::init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight)
+void GameLevel::init(const unsigned char* codes, unsigned int width, unsigned int height, unsigned int levelWidth, unsigned int levelHeight)
 {
     // calculate dimensions
-    unsigned int height = tileData.size();
-    unsigned int width = tileData[0].size(); // note we can index vector at [0] since this function is only called if height > 0
-    float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / height;
-    // initialize level tiles based on tileData		
+    float unit_width = levelWidth / static_cast<float>(width), unit_height = levelHeight / static_cast<float>(height);
+    if (!(unit_width > 0.0f && unit_height > 0.0f && std::isfinite(unit_width) && std::isfinite(unit_height)))
+    {
+        std::cout << "ERROR::LEVEL: A " << width << "x" << height << " level doesn't fit a " << levelWidth << "x" << levelHeight << " area" << std::endl;
+        return;
+    }
+    // bricks never move, so the lattice itself serves as the broadphase grid
+    this->GridWidth = width;
+    this->GridHeight = height;
+    this->UnitWidth = unit_width;
+    this->UnitHeight = unit_height;
+    this->Cells.assign(static_cast<size_t>(width) * height, -1);
+    size_t cells = this->Cells.size();
+    this->Bricks.Reserve(static_cast<unsigned int>(cells - std::count(codes, codes + cells, 0)));
+    // initialize level tiles based on the tile codes
     for (unsigned int y = 0; y < height; ++y)
     {
+        const unsigned char* row = codes + static_cast<size_t>(y) * width;
         for (unsigned int x = 0; x < width; ++x)
         {
-            // check block type from level data (2D level array)
-            if (tileData[y][x] == 1) // solid
-            {
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                GameObject obj(pos, size, ResourceManager::GetTexture("block_solid"), glm::vec3(0.8f, 0.8f, 0.7f));
-                obj.IsSolid = true;
-                this->Bricks.push_back(obj);
-            }
-            else if (tileData[y][x] > 1)	// non-solid; now determine its color based on level data
-            {
-                glm::vec3 color = glm::vec3(1.0f); // original: white
-                if (tileData[y][x] == 2)
-                    color = glm::vec3(0.2f, 0.6f, 1.0f);
-                else if (tileData[y][x] == 3)
-                    color = glm::vec3(0.0f, 0.7f, 0.0f);
-                else if (tileData[y][x] == 4)
-                    color = glm::vec3(0.8f, 0.8f, 0.4f);
-                else if (tileData[y][x] == 5)
-                    color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-                glm::vec2 pos(unit_width * x, unit_height * y);
-                glm::vec2 size(unit_width, unit_height);
-                this->Bricks.push_back(GameObject(pos, size, ResourceManager::GetTexture("block"), color));
-            }
+            // check block type from level data
+            unsigned int tileCode = row[x];
+            if (tileCode == 0)
+                continue;
+            glm::vec2 pos(unit_width * x, unit_height * y);
+            glm::vec2 size(unit_width, unit_height);
+            unsigned char color = tileCode < 6 ? tileCode : 0; // the palette is indexed by tile code
+            unsigned char flags = 0;
+            if (tileCode == 1) // solid
+                flags |= BRICK_SOLID;
+            else
+                ++this->BreakableLeft;
+            this->Cells[static_cast<size_t>(y) * width + x] = this->Bricks.Count();
+            this->Bricks.Add(pos, size, color, flags);
         }
     }
 }
\ No newline at end of file
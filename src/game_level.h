@@ -2,32 +2,78 @@
 #define GAMELEVEL_H
 #include <vector>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "game_object.h"
-#include "sprite_renderer.h"
-#include "Managers/resource_manager.h"
+
+// Per-brick state bits packed into BrickStore::Flags
+enum BrickFlags : unsigned char {
+    BRICK_SOLID           = 1 << 0,
+    BRICK_DESTROYED       = 1 << 1,
+    BRICK_SPAWNED_POWERUP = 1 << 2
+};
+
+// BrickStore keeps the bricks of a level as parallel arrays (structure of arrays)
+// so collision and draw loops only pull in the data they actually touch.
+struct BrickStore {
+    std::vector<float>         X, Y;          // top-left corner
+    std::vector<float>         Width, Height;
+    std::vector<unsigned char> ColorIndex;    // index into GameLevel::Palette
+    std::vector<unsigned char> Flags;         // BrickFlags
+
+    unsigned int Count() const { return static_cast<unsigned int>(this->X.size()); }
+    glm::vec2    Position(unsigned int i) const { return glm::vec2(this->X[i], this->Y[i]); }
+    glm::vec2    Size(unsigned int i) const { return glm::vec2(this->Width[i], this->Height[i]); }
+    bool         IsSolid(unsigned int i) const { return (this->Flags[i] & BRICK_SOLID) != 0; }
+    bool         IsDestroyed(unsigned int i) const { return (this->Flags[i] & BRICK_DESTROYED) != 0; }
+    void Clear()
+    {
+        X.clear(); Y.clear(); Width.clear(); Height.clear(); ColorIndex.clear(); Flags.clear();
+    }
+    void Reserve(unsigned int count)
+    {
+        X.reserve(count); Y.reserve(count); Width.reserve(count); Height.reserve(count); ColorIndex.reserve(count); Flags.reserve(count);
+    }
+    void Add(glm::vec2 pos, glm::vec2 size, unsigned char color, unsigned char flags)
+    {
+        X.push_back(pos.x); Y.push_back(pos.y);
+        Width.push_back(size.x); Height.push_back(size.y);
+        ColorIndex.push_back(color);
+        Flags.push_back(flags);
+    }
+};
 
 
-/// GameLevel holds all Tiles as part of a Breakout level and 
-/// hosts functionality to Load/render levels from the harddisk.
 class GameLevel
 {
 public:
     // level state
-    std::vector<GameObject> Bricks;
+    BrickStore       Bricks;
+    // number of non-solid bricks that are not destroyed yet
+    unsigned int     BreakableLeft;
+    // brick colors, indexed by tile code (codes without a color of their own use entry 0)
+    static const glm::vec3 Palette[6];
+    // broadphase grid: the lattice the bricks were laid out on, with the brick index of every cell (-1 if empty)
+    unsigned int     GridWidth, GridHeight;
+    float            UnitWidth, UnitHeight;
+    std::vector<int> Cells;
     // constructor
-    GameLevel() { }
-    // loads level from file
+    GameLevel() : BreakableLeft(0), GridWidth(0), GridHeight(0), UnitWidth(0.0f), UnitHeight(0.0f) { }
+    // loads level from file, either a compiled level (see level_format.h) or the text format
     void Load(const char* file, unsigned int levelWidth, unsigned int levelHeight);
-    // render level
-    void Draw(SpriteRenderer& renderer);
+    // lower edge of the brick lattice; nothing below it can be hit
+    float Bottom() const { return this->GridHeight * this->UnitHeight; }
     // check if the level is completed (all non-solid tiles are destroyed)
-    bool IsCompleted();
+    bool IsCompleted() const { return this->BreakableLeft == 0; }
+    // puts the bricks back the way they are in pristine, the same level as loaded (play only changes
+    // the brick flags, so this is a plain copy of those, without any allocation or file access)
+    void Reset(const GameLevel& pristine);
+    // marks a brick as destroyed, keeping the count of breakable bricks up to date
+    void DestroyBrick(unsigned int index);
+    // collects the indices of all bricks whose lattice cell overlaps the given box (in ascending brick order)
+    void QueryBricks(glm::vec2 min, glm::vec2 max, std::vector<unsigned int>& result) const;
 private:
-    // initialize level from tile data
-    void init(std::vector<std::vector<unsigned int>> tileData, unsigned int levelWidth, unsigned int levelHeight);
+    // initialize level from tile codes (width * height, row by row)
+    void init(const unsigned char* codes, unsigned int width, unsigned int height, unsigned int levelWidth, unsigned int levelHeight);
 };
 
 #endif
\ No newline at end of file
@@ -1,33 +1,27 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "texture.h"
-#include "sprite_renderer.h"
-
 
 // Container object for holding all state relevant for a single
 // game object entity. Each object in the game likely needs the
 // minimal of state as described within GameObject.
+// Holds no render state, so the simulation can run without a GL context;
+// the renderer picks the texture for each kind of object.
 class GameObject
 {
 public:
     // object state
     glm::vec2   Position, Size, Velocity;
+    glm::vec2   PreviousPosition; // position at the start of the current simulation step (for render interpolation)
     glm::vec3   Color;
     float       Rotation;
     bool        IsSolid;
     bool        Destroyed;
-    bool        HasSpawnedPowerUp = false;
-    // render state
-    Texture2D   Sprite;
     // constructor(s)
     GameObject();
-    GameObject(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
-    // draw sprite
-    virtual void Draw(SpriteRenderer& renderer);
+    GameObject(glm::vec2 pos, glm::vec2 size, glm::vec3 color = glm::vec3(1.0f), glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio.h"
+#include "job_system.h"
+#include "simulation.h"
+#include "software_mixer.h"
+#include "wav_file.h"
+
+// Runs whole games of Breakout without a window, GL context or audio device.
+// The paddle is flown by a simple autopilot that chases the lowest falling ball.
+//
+// usage: breakout_headless [games] [levels directory] [ball storm size] [threads (0: all)] [seed] [audio] [music]
+// where audio is "none" (the default), "null" (mix the sound and throw it away) or a .wav file to mix into,
+// and music is a comma separated list of .wav tracks, played level by level in turn
+
+// The size of the (virtual) screen; matches the windowed game
+const unsigned int SCREEN_WIDTH = 800;
+const unsigned int SCREEN_HEIGHT = 600;
+
+// Counts what happened over all games
+class EventCounter : public SimulationListener
+{
+public:
+    unsigned long long Counts[EVENT_TYPE_COUNT];
+    EventCounter() : Counts() { }
+    void OnSimulationEvent(const SimulationEvent& event) { ++this->Counts[event.Type]; }
+};
+
+// Plays the sound of each event, like the windowed game does
+class SoundPlayer : public SimulationListener
+{
+public:
+    AudioSystem& Audio;
+    SoundHandle  Sounds[EVENT_TYPE_COUNT];
+    explicit SoundPlayer(AudioSystem& audio) : Audio(audio), Sounds() { }
+    void OnSimulationEvent(const SimulationEvent& event) { this->Audio.Play(this->Sounds[event.Type], event.Position.x / SCREEN_WIDTH * 2.0f - 1.0f); }
+};
+
+// moves the paddle under the lowest ball that is on its way down and launches stuck balls
+void Autopilot(Simulation& world, float dt)
+{
+    const BallStore& balls = world.Balls;
+    int target = -1;
+    for (unsigned int i = 0; i < balls.Count(); ++i)
+        if (!balls.IsStuck(i) && balls.VelocityY[i] > 0.0f && (target < 0 || balls.Y[i] > balls.Y[target]))
+            target = i;
+    if (target >= 0)
+    {
+        float distance = (balls.X[target] + balls.Radius[target]) - (world.Player.Position.x + world.Player.Size.x / 2.0f);
+        if (std::abs(distance) > world.Player.Size.x / 4.0f)
+            world.MovePaddle(distance, dt);
+    }
+    world.LaunchBall();
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int games = argc > 1 ? static_cast<unsigned int>(std::atoi(argv[1])) : 10;
+    std::string directory = argc > 2 ? argv[2] : "src/Resources/levels";
+    unsigned int storm = argc > 3 ? static_cast<unsigned int>(std::atoi(argv[3])) : 0;
+    unsigned int threads = argc > 4 ? static_cast<unsigned int>(std::atoi(argv[4])) : 1;
+    unsigned long long seed = argc > 5 ? std::strtoull(argv[5], nullptr, 0) : DEFAULT_SEED;
+    std::string output = argc > 6 ? argv[6] : "none";
+    std::string sound = directory + "/../audio/";
+    // the game's own track is an mp3, which the mixer can't read; the sound effects stand in for it by default
+    std::string tracks = argc > 7 ? argv[7] : sound + "bleep.wav," + sound + "powerup.wav," + sound + "solid.wav";
+
+    Simulation world(SCREEN_WIDTH, SCREEN_HEIGHT);
+    world.LoadLevels(directory);
+    world.Seed(seed);
+    if (world.Catalog.Count() == 0 || world.Current.Bricks.Count() == 0)
+    {
+        std::cout << "ERROR::HEADLESS: Failed to load levels from " << directory << std::endl;
+        return 1;
+    }
+    JobSystem jobs(threads);
+    world.Jobs = &jobs;
+    EventCounter counter;
+    world.Subscribe(&counter);
+
+    // the full audio path, minus the sound device: sounds are mixed in software as game time
+    // passes, on this thread (so the output only depends on the game, not on timing)
+    std::unique_ptr<AudioSink> sink;
+    std::unique_ptr<AudioBackend> backend;
+    if (output == "null")
+        sink.reset(new NullSink());
+    else if (output != "none")
+        sink.reset(new WavWriter(output.c_str(), MIXER_RATE));
+    if (sink)
+        backend.reset(new SoftwareMixer(sink.get()));
+    else
+        backend.reset(new NullAudioBackend());
+    AudioSystem audio(backend.get());
+    SoundPlayer sounds(audio);
+    // the mixer only reads .wav files, so bricks use the paddle's bleep instead of bleep.mp3
+    sounds.Sounds[EVENT_BRICK_DESTROYED] = audio.LoadSound((sound + "bleep.wav").c_str(), 0.7f);
+    sounds.Sounds[EVENT_SOLID_HIT] = audio.LoadSound((sound + "solid.wav").c_str(), 0.7f);
+    sounds.Sounds[EVENT_PADDLE_HIT] = audio.LoadSound((sound + "bleep.wav").c_str(), 0.7f);
+    sounds.Sounds[EVENT_POWERUP_COLLECTED] = audio.LoadSound((sound + "powerup.wav").c_str(), 0.7f);
+    world.Subscribe(&sounds);
+    // each level streams a track of its own, so switching levels hands one stream over to the next
+    std::vector<SoundHandle> music;
+    for (size_t first = 0; first <= tracks.size();)
+    {
+        size_t last = std::min(tracks.find(',', first), tracks.size());
+        if (last > first)
+            music.push_back(audio.LoadMusic(tracks.substr(first, last - first).c_str()));
+        first = last + 1;
+    }
+    std::vector<SoundHandle> levelMusic;
+    for (unsigned int level = 0; level < world.Catalog.Count() && !music.empty(); ++level)
+        levelMusic.push_back(music[level % music.size()]);
+
+    unsigned int wins = 0;
+    unsigned long long steps = 0, checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int game = 0; game < games; ++game)
+    {
+        world.SelectLevel(static_cast<int>(game % world.Catalog.Count()) - static_cast<int>(world.Level));
+        if (!levelMusic.empty())
+        {   // like the game: play the level's track, and get the next level's ready while this one is played
+            audio.PlayMusic(levelMusic[world.Level]);
+            audio.PrefetchMusic(levelMusic[(game + 1) % world.Catalog.Count()]);
+        }
+        world.Start();
+        if (storm > 0)
+            world.StartBallStorm(storm);
+        // a game ends on the win screen or back in the menu (out of lives or out of time)
+        while (world.State == GAME_ACTIVE)
+        {
+            world.BeginStep();
+            Autopilot(world, SIMULATION_STEP);
+            world.Update(SIMULATION_STEP);
+            audio.Flush(SIMULATION_STEP);
+            jobs.WaitForFrame();
+            // mixed into one value for the whole run, so runs with different thread counts can be compared
+            checksum = checksum * 31 + world.Checksum();
+            ++steps;
+        }
+        if (world.State == GAME_WIN)
+        {
+            ++wins;
+            world.ReturnToMenu();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "threads: " << jobs.ThreadCount() << std::endl;
+    std::cout << "games: " << games << " (won " << wins << ")" << std::endl;
+    std::cout << "steps: " << steps << " (" << steps * SIMULATION_STEP << "s of game time)" << std::endl;
+    std::cout << "bricks destroyed: " << counter.Counts[EVENT_BRICK_DESTROYED] << ", solid hits: " << counter.Counts[EVENT_SOLID_HIT]
+              << ", paddle hits: " << counter.Counts[EVENT_PADDLE_HIT] << ", power-ups: " << counter.Counts[EVENT_POWERUP_COLLECTED] << std::endl;
+    std::cout << "state checksum: " << std::hex << checksum << std::dec << std::endl;
+    std::cout << "wall time: " << seconds << "s (" << (seconds > 0.0 ? steps / seconds : 0.0) << " steps/s)" << std::endl;
+    return 0;
+}
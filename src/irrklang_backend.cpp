@@ -0,0 +1,71 @@
+#include "irrklang_backend.h"
+
+
+IrrKlangBackend::IrrKlangBackend()
+    : engine(irrklang::createIrrKlangDevice())
+{
+
+}
+
+IrrKlangBackend::~IrrKlangBackend()
+{
+    for (irrklang::ISound* voice : this->voices)
+        if (voice)
+            voice->drop();
+    if (this->engine)
+        this->engine->drop();
+}
+
+int IrrKlangBackend::LoadSound(const char* file, bool stream)
+{
+    if (!this->engine)
+        return -1;
+    // sound effects are decoded right away; music streams while it plays
+    irrklang::ISoundSource* source = this->engine->addSoundSourceFromFile(file, stream ? irrklang::ESM_AUTO_DETECT : irrklang::ESM_NO_STREAMING, !stream);
+    if (!source)
+        source = this->engine->getSoundSource(file, false); // already loaded
+    if (!source)
+        return -1;
+    this->sources.push_back(source);
+    return static_cast<int>(this->sources.size() - 1);
+}
+
+VoiceHandle IrrKlangBackend::StartVoice(int sample, float volume, float pan, bool looped)
+{
+    if (sample < 0)
+        return 0;
+    irrklang::ISound* sound = this->engine->play2D(this->sources[sample], looped, true, true);
+    if (!sound)
+        return 0;
+    sound->setVolume(volume);
+    sound->setPan(pan);
+    sound->setIsPaused(false);
+    VoiceHandle voice;
+    if (!this->freeVoices.empty())
+    {
+        voice = this->freeVoices.back();
+        this->freeVoices.pop_back();
+        this->voices[voice - 1] = sound;
+    }
+    else
+    {
+        this->voices.push_back(sound);
+        voice = static_cast<VoiceHandle>(this->voices.size());
+    }
+    return voice;
+}
+
+bool IrrKlangBackend::IsPlaying(VoiceHandle voice)
+{
+    return voice != 0 && this->voices[voice - 1] && !this->voices[voice - 1]->isFinished();
+}
+
+void IrrKlangBackend::StopVoice(VoiceHandle voice)
+{
+    if (voice == 0 || !this->voices[voice - 1])
+        return;
+    this->voices[voice - 1]->stop();
+    this->voices[voice - 1]->drop();
+    this->voices[voice - 1] = nullptr;
+    this->freeVoices.push_back(voice);
+}
\ No newline at end of file
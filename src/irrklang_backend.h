@@ -0,0 +1,29 @@
+#ifndef IRRKLANG_BACKEND_H
+#define IRRKLANG_BACKEND_H
+#include <vector>
+
+#include <irrklang/irrKlang.h>
+
+#include "audio_backend.h"
+
+
+// IrrKlangBackend plays sounds through an irrKlang sound engine (which mixes in
+// real time on its own and can play .mp3 as well as .wav files)
+class IrrKlangBackend : public AudioBackend
+{
+public:
+    // constructor/destructor; creates the irrKlang device
+    IrrKlangBackend();
+    ~IrrKlangBackend();
+    int         LoadSound(const char* file, bool stream);
+    VoiceHandle StartVoice(int sample, float volume, float pan, bool looped);
+    bool        IsPlaying(VoiceHandle voice);
+    void        StopVoice(VoiceHandle voice);
+private:
+    irrklang::ISoundEngine*              engine;
+    std::vector<irrklang::ISoundSource*> sources;
+    std::vector<irrklang::ISound*>       voices;    // a voice's handle is its index + 1
+    std::vector<VoiceHandle>             freeVoices;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+
+// the system and queue a worker thread belongs to
+static thread_local const JobSystem* workerSystem = nullptr;
+static thread_local unsigned int     workerQueue = 0;
+
+JobSystem::JobSystem(unsigned int threads)
+    : jobs(new Job[MAX_JOBS]), queues(), queued(0), frameJobs(0), quit(false)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    // every slot starts out free; generation 0 is never handed out so default handles are always finished
+    this->freeJobs.reserve(MAX_JOBS);
+    for (unsigned int i = MAX_JOBS; i-- > 0;)
+    {
+        this->jobs[i].Pending = 0;
+        this->jobs[i].Generation = 1;
+        this->freeJobs.push_back(i);
+    }
+    this->queues.reset(new Queue[threads]);
+    for (unsigned int i = 1; i < threads; ++i)
+        this->workers.push_back(std::thread(&JobSystem::work, this, i));
+}
+
+JobSystem::~JobSystem()
+{
+    this->WaitForFrame();
+    this->quit = true;
+    {
+        std::lock_guard<std::mutex> lock(this->sleepLock);
+    }
+    this->wake.notify_all();
+    for (std::thread& worker : this->workers)
+        worker.join();
+}
+
+JobHandle JobSystem::Schedule(Task task, JobHandle dependency)
+{
+    return this->Schedule(std::move(task), std::vector<JobHandle>(1, dependency));
+}
+
+JobHandle JobSystem::Schedule(Task task, const std::vector<JobHandle>& dependencies)
+{
+    unsigned int index = this->allocate();
+    Job& job = this->jobs[index];
+    job.Work = std::move(task);
+    job.Pending = 1; // held until all dependencies are registered
+    JobHandle handle(index, job.Generation);
+    ++this->frameJobs;
+    for (const JobHandle& dependency : dependencies)
+    {
+        Job& parent = this->jobs[dependency.Index];
+        std::lock_guard<std::mutex> lock(parent.Lock);
+        if (parent.Generation == dependency.Generation)
+        {   // still running: let it start this job once it's done
+            ++job.Pending;
+            parent.Continuations.push_back(index);
+        }
+    }
+    if (--job.Pending == 0)
+        this->enqueue(index);
+    return handle;
+}
+
+JobHandle JobSystem::ParallelFor(unsigned int begin, unsigned int end, unsigned int grain, RangeTask body, JobHandle dependency)
+{
+    if (end <= begin)
+        return dependency;
+    grain = std::max(grain, 1u);
+    if (end - begin <= grain && this->IsFinished(dependency))
+    {   // not worth a job
+        body(begin, end);
+        return JobHandle();
+    }
+    std::shared_ptr<RangeTask> shared = std::make_shared<RangeTask>(std::move(body));
+    std::vector<JobHandle> chunks;
+    for (unsigned int first = begin; first < end;)
+    {
+        unsigned int last = end - first > grain ? first + grain : end;
+        chunks.push_back(this->Schedule([shared, first, last]() { (*shared)(first, last); }, dependency));
+        first = last;
+    }
+    // a job without work that finishes with the last chunk
+    return this->Schedule([]() { }, chunks);
+}
+
+bool JobSystem::IsFinished(JobHandle job) const
+{
+    return this->jobs[job.Index].Generation != job.Generation;
+}
+
+void JobSystem::Wait(JobHandle job)
+{
+    while (!this->IsFinished(job))
+        if (!this->help())
+            std::this_thread::yield();
+}
+
+void JobSystem::WaitForFrame()
+{
+    while (this->frameJobs > 0)
+        if (!this->help())
+            std::this_thread::yield();
+}
+
+void JobSystem::work(unsigned int queue)
+{
+    workerSystem = this;
+    workerQueue = queue;
+    while (!this->quit)
+    {
+        unsigned int job;
+        if (this->take(queue, job))
+        {
+            this->run(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->sleepLock);
+        this->wake.wait(lock, [this]() { return this->quit || this->queued > 0; });
+    }
+}
+
+unsigned int JobSystem::currentQueue() const
+{
+    return workerSystem == this ? workerQueue : 0;
+}
+
+unsigned int JobSystem::allocate()
+{
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->freeLock);
+            if (!this->freeJobs.empty())
+            {
+                unsigned int index = this->freeJobs.back();
+                this->freeJobs.pop_back();
+                return index;
+            }
+        }
+        // every slot is taken; finish some jobs to free one up
+        if (!this->help())
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::enqueue(unsigned int job)
+{
+    Queue& queue = this->queues[this->currentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        queue.Jobs.push_back(job);
+    }
+    ++this->queued;
+    // taking the lock makes sure a worker that is about to sleep sees the new job
+    {
+        std::lock_guard<std::mutex> lock(this->sleepLock);
+    }
+    this->wake.notify_one();
+}
+
+bool JobSystem::take(unsigned int queue, unsigned int& job)
+{
+    if (this->queued <= 0)
+        return false;
+    // newest job of our own queue first (it's the most likely to be in cache)...
+    {
+        Queue& own = this->queues[queue];
+        std::lock_guard<std::mutex> lock(own.Lock);
+        if (!own.Jobs.empty())
+        {
+            job = own.Jobs.back();
+            own.Jobs.pop_back();
+            --this->queued;
+            return true;
+        }
+    }
+    // ...otherwise steal the oldest job of another queue
+    unsigned int count = this->ThreadCount();
+    for (unsigned int i = 1; i < count; ++i)
+    {
+        Queue& victim = this->queues[(queue + i) % count];
+        std::lock_guard<std::mutex> lock(victim.Lock);
+        if (!victim.Jobs.empty())
+        {
+            job = victim.Jobs.front();
+            victim.Jobs.pop_front();
+            --this->queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::run(unsigned int index)
+{
+    Job& job = this->jobs[index];
+    job.Work();
+    job.Work = nullptr;
+    // finish the job, then start whatever was only waiting for it
+    std::vector<unsigned int> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job.Lock);
+        continuations.swap(job.Continuations);
+        ++job.Generation;
+    }
+    for (unsigned int next : continuations)
+        if (--this->jobs[next].Pending == 0)
+            this->enqueue(next);
+    {
+        std::lock_guard<std::mutex> lock(this->freeLock);
+        this->freeJobs.push_back(index);
+    }
+    --this->frameJobs;
+}
+
+bool JobSystem::help()
+{
+    unsigned int job;
+    if (!this->take(this->currentQueue(), job))
+        return false;
+    this->run(job);
+    return true;
+}
\ No newline at end of file
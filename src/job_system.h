@@ -0,0 +1,87 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Refers to a scheduled job. A default constructed handle refers to no job
+// and counts as finished, so it can always be passed as a dependency.
+struct JobHandle {
+    unsigned int Index;
+    unsigned int Generation;
+
+    JobHandle() : Index(0), Generation(0) { }
+    JobHandle(unsigned int index, unsigned int generation) : Index(index), Generation(generation) { }
+};
+
+// JobSystem is a small work-stealing task scheduler. Every worker thread owns a
+// queue: it pushes and pops its own jobs at the back and, once it runs dry, steals
+// from the front of the other queues. Threads that wait for a job help out by
+// running jobs themselves, so a JobSystem with a single thread runs everything on
+// the waiting thread, in order.
+class JobSystem
+{
+public:
+    typedef std::function<void()> Task;
+    typedef std::function<void(unsigned int, unsigned int)> RangeTask;
+    // maximum number of jobs in flight at once
+    static const unsigned int MAX_JOBS = 4096;
+    // constructor/destructor; threads counts the thread that waits as well (0 uses every hardware thread)
+    explicit JobSystem(unsigned int threads = 0);
+    ~JobSystem();
+    // number of threads jobs run on (the workers plus the waiting thread)
+    unsigned int ThreadCount() const { return static_cast<unsigned int>(this->workers.size()) + 1; }
+    // schedules a task to run once all of its dependencies have finished
+    JobHandle Schedule(Task task, const std::vector<JobHandle>& dependencies = std::vector<JobHandle>());
+    JobHandle Schedule(Task task, JobHandle dependency);
+    // runs body(chunkBegin, chunkEnd) over [begin, end) in chunks of at most grain items, in parallel; the returned
+    // job finishes once every chunk has. A range that fits in one chunk runs right away on the calling thread.
+    JobHandle ParallelFor(unsigned int begin, unsigned int end, unsigned int grain, RangeTask body, JobHandle dependency = JobHandle());
+    // checks/waits for a job to finish; waiting threads run other jobs in the meantime
+    bool IsFinished(JobHandle job) const;
+    void Wait(JobHandle job);
+    // waits until every job scheduled since the last WaitForFrame has finished
+    void WaitForFrame();
+private:
+    struct Job {
+        Task                      Work;
+        std::atomic<int>          Pending;       // unfinished dependencies (+1 while being scheduled)
+        std::atomic<unsigned int> Generation;    // bumped when the job finishes, which invalidates its handles
+        std::vector<unsigned int> Continuations; // jobs waiting for this one
+        std::mutex                Lock;          // guards Continuations and the bump of Generation
+    };
+    struct Queue {
+        std::mutex                Lock;
+        std::deque<unsigned int>  Jobs;
+    };
+    // state
+    std::unique_ptr<Job[]>             jobs;
+    std::vector<unsigned int>          freeJobs;
+    std::mutex                         freeLock;
+    std::unique_ptr<Queue[]>           queues;   // queue 0 takes jobs scheduled from outside the workers
+    std::vector<std::thread>           workers;
+    std::atomic<int>                   queued;   // jobs sitting in a queue
+    std::atomic<int>                   frameJobs;
+    std::atomic<bool>                  quit;
+    std::mutex                         sleepLock;
+    std::condition_variable            wake;
+    // worker thread body
+    void work(unsigned int queue);
+    // queue of the calling thread (0 for threads that aren't workers of this system)
+    unsigned int currentQueue() const;
+    unsigned int allocate();
+    void enqueue(unsigned int job);
+    // takes a job from the given queue, or steals one from another queue
+    bool take(unsigned int queue, unsigned int& job);
+    void run(unsigned int job);
+    // runs one pending job if there is any; returns false otherwise
+    bool help();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "level_catalog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+
+// the names of the files in a directory
+static std::vector<std::string> listDirectory(const std::string& directory)
+{
+    std::vector<std::string> names;
+#ifdef _WIN32
+    WIN32_FIND_DATAA found;
+    HANDLE search = FindFirstFileA((directory + "\\*").c_str(), &found);
+    if (search == INVALID_HANDLE_VALUE)
+        return names;
+    do
+    {
+        if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            names.push_back(found.cFileName);
+    } while (FindNextFileA(search, &found));
+    FindClose(search);
+#else
+    DIR* listing = opendir(directory.c_str());
+    if (!listing)
+        return names;
+    while (dirent* entry = readdir(listing))
+        if (entry->d_name[0] != '.')
+            names.push_back(entry->d_name);
+    closedir(listing);
+#endif
+    return names;
+}
+
+// compares names the way people count: runs of digits by their value, so level2 comes before level10
+static bool naturalLess(const std::string& a, const std::string& b)
+{
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size())
+    {
+        bool digitA = a[i] >= '0' && a[i] <= '9', digitB = b[j] >= '0' && b[j] <= '9';
+        if (!digitA || !digitB)
+        {
+            if (a[i] != b[j])
+                return a[i] < b[j];
+            ++i, ++j;
+            continue;
+        }
+        // skip leading zeros, then the longer number is the bigger one
+        while (i < a.size() && a[i] == '0') ++i;
+        while (j < b.size() && b[j] == '0') ++j;
+        size_t endA = i, endB = j;
+        while (endA < a.size() && a[endA] >= '0' && a[endA] <= '9') ++endA;
+        while (endB < b.size() && b[endB] >= '0' && b[endB] <= '9') ++endB;
+        if (endA - i != endB - j)
+            return endA - i < endB - j;
+        int order = a.compare(i, endA - i, b, j, endB - j);
+        if (order != 0)
+            return order < 0;
+        i = endA, j = endB;
+    }
+    return a.size() - i < b.size() - j;
+}
+
+// memory a loaded level takes up (roughly: its arrays)
+static std::size_t memoryOf(const GameLevel& level)
+{
+    const BrickStore& bricks = level.Bricks;
+    return sizeof(GameLevel) + (bricks.X.capacity() + bricks.Y.capacity() + bricks.Width.capacity() + bricks.Height.capacity()) * sizeof(float)
+        + bricks.ColorIndex.capacity() + bricks.Flags.capacity() + level.Cells.capacity() * sizeof(int);
+}
+
+LevelCatalog::LevelCatalog(unsigned int levelWidth, unsigned int levelHeight, std::size_t budget)
+    : levelWidth(levelWidth), levelHeight(levelHeight), budget(budget), clock(0), memory(0), running(false)
+{
+
+}
+
+LevelCatalog::~LevelCatalog()
+{
+    this->stop();
+}
+
+unsigned int LevelCatalog::Discover(const std::string& directory)
+{
+    this->stop();
+    // a compiled level stands in for the text level of the same name
+    std::map<std::string, std::string> levels;
+    for (const std::string& name : listDirectory(directory))
+    {
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos)
+            continue;
+        std::string stem = name.substr(0, dot), extension = name.substr(dot);
+        if (extension == ".blvl" || (extension == ".lvl" && levels.find(stem) == levels.end()))
+            levels[stem] = name;
+    }
+    std::vector<std::string> names;
+    for (const auto& level : levels)
+        names.push_back(level.second);
+    std::sort(names.begin(), names.end(), naturalLess);
+
+    this->entries.clear();
+    this->memory = 0;
+    for (const std::string& name : names)
+    {
+        Entry entry;
+        entry.File = directory + "/" + name;
+        entry.Loading = false;
+        entry.LastUse = 0;
+        entry.Memory = 0;
+        this->entries.push_back(entry);
+    }
+    if (!this->entries.empty())
+    {
+        this->running = true;
+        this->thread = std::thread(&LevelCatalog::run, this);
+    }
+    return this->Count();
+}
+
+std::shared_ptr<const GameLevel> LevelCatalog::Get(unsigned int index)
+{
+    std::unique_lock<std::mutex> held(this->lock);
+    Entry& entry = this->entries[index];
+    entry.LastUse = ++this->clock;
+    while (entry.Loading)
+        this->loaded.wait(held);
+    if (!entry.Level)
+        this->load(held, index);
+    return entry.Level;
+}
+
+void LevelCatalog::Prefetch(unsigned int index)
+{
+    std::lock_guard<std::mutex> held(this->lock);
+    this->queue.clear();
+    int count = static_cast<int>(this->entries.size());
+    for (int distance = 0; distance <= static_cast<int>(LEVEL_PREFETCH_RADIUS); ++distance)
+    {
+        for (int side = distance == 0 ? 1 : -1; side <= 1; side += 2)
+        {
+            unsigned int neighbour = static_cast<unsigned int>(((static_cast<int>(index) + side * distance) % count + count) % count);
+            Entry& entry = this->entries[neighbour];
+            // loaded neighbours count as used, so they are the last to go
+            entry.LastUse = ++this->clock;
+            if (!entry.Level && !entry.Loading)
+                this->queue.push_back(neighbour);
+        }
+    }
+    this->requested.notify_one();
+}
+
+std::size_t LevelCatalog::MemoryUse()
+{
+    std::lock_guard<std::mutex> held(this->lock);
+    return this->memory;
+}
+
+void LevelCatalog::run()
+{
+    std::unique_lock<std::mutex> held(this->lock);
+    while (this->running)
+    {
+        if (this->queue.empty())
+        {
+            this->requested.wait(held);
+            continue;
+        }
+        unsigned int index = this->queue.front();
+        this->queue.pop_front();
+        Entry& entry = this->entries[index];
+        if (!entry.Level && !entry.Loading)
+            this->load(held, index);
+    }
+}
+
+void LevelCatalog::load(std::unique_lock<std::mutex>& held, unsigned int index)
+{
+    this->entries[index].Loading = true;
+    std::string file = this->entries[index].File;
+    held.unlock();
+    std::shared_ptr<GameLevel> level(new GameLevel());
+    level->Load(file.c_str(), this->levelWidth, this->levelHeight);
+    held.lock();
+    Entry& entry = this->entries[index];
+    entry.Level = level;
+    entry.Loading = false;
+    entry.Memory = memoryOf(*level);
+    this->memory += entry.Memory;
+    this->evict();
+    this->loaded.notify_all();
+}
+
+void LevelCatalog::evict()
+{
+    while (this->memory > this->budget)
+    {
+        // levels held outside the catalog (use_count > 1) are in use and stay
+        Entry* oldest = nullptr;
+        for (Entry& entry : this->entries)
+            if (entry.Level && entry.Level.use_count() == 1 && (!oldest || entry.LastUse < oldest->LastUse))
+                oldest = &entry;
+        if (!oldest)
+            break;
+        oldest->Level.reset();
+        this->memory -= oldest->Memory;
+        oldest->Memory = 0;
+    }
+}
+
+void LevelCatalog::stop()
+{
+    {
+        std::lock_guard<std::mutex> held(this->lock);
+        if (!this->running)
+            return;
+        this->running = false;
+        this->queue.clear();
+    }
+    this->requested.notify_one();
+    this->thread.join();
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef LEVEL_CATALOG_H
+#define LEVEL_CATALOG_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_level.h"
+
+
+// Memory the loaded levels of a catalog may take up before the least recently used are dropped
+const std::size_t LEVEL_CACHE_BUDGET = 64 * 1024 * 1024;
+// Number of levels on either side of the selected one that are loaded ahead
+const unsigned int LEVEL_PREFETCH_RADIUS = 1;
+
+// LevelCatalog knows the levels of a campaign: the level files of a directory (text
+// .lvl or compiled .blvl, in natural name order, so level2 comes before level10). A
+// level is only loaded once it is asked for, and a background thread loads the ones
+// next to the selected level ahead of time so switching to them doesn't wait on the
+// disk. Loaded levels are pristine templates shared with whoever uses them; once they
+// take up more than the budget, the least recently used ones nobody holds are dropped.
+class LevelCatalog
+{
+public:
+    // constructor/destructor; levels are laid out over levelWidth x levelHeight
+    LevelCatalog(unsigned int levelWidth, unsigned int levelHeight, std::size_t budget = LEVEL_CACHE_BUDGET);
+    ~LevelCatalog();
+    // finds the levels in directory (replacing any found before); returns how many there are
+    unsigned int       Discover(const std::string& directory);
+    unsigned int       Count() const { return static_cast<unsigned int>(this->entries.size()); }
+    const std::string& File(unsigned int index) const { return this->entries[index].File; }
+    // the pristine level; loads it right here if it isn't loaded yet (or waits for the
+    // background thread if it is loading it already)
+    std::shared_ptr<const GameLevel> Get(unsigned int index);
+    // has the background thread load the levels around index (dropping earlier requests)
+    void               Prefetch(unsigned int index);
+    // memory taken up by the loaded levels
+    std::size_t        MemoryUse();
+private:
+    struct Entry {
+        std::string                      File;
+        std::shared_ptr<const GameLevel> Level;   // nullptr until loaded
+        bool                             Loading;
+        unsigned long long               LastUse; // of the use clock
+        std::size_t                      Memory;  // taken up by Level
+    };
+    unsigned int              levelWidth, levelHeight;
+    std::size_t               budget;
+    std::vector<Entry>        entries;
+    // guarded by lock
+    std::mutex                lock;
+    std::condition_variable   requested; // a prefetch was asked for (or the catalog is going away)
+    std::condition_variable   loaded;    // a level finished loading
+    std::deque<unsigned int>  queue;     // levels to prefetch, nearest first
+    unsigned long long        clock;
+    std::size_t               memory;
+    bool                      running;
+    std::thread               thread;
+    // background thread: loads the requested levels until the catalog goes away
+    void run();
+    // loads a level (with the lock held on entry and return; it is let go while loading)
+    void load(std::unique_lock<std::mutex>& held, unsigned int index);
+    // drops least recently used levels nobody holds until the loaded levels fit the budget
+    void evict();
+    void stop();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <iostream>
+
+#include "level_format.h"
+#include "mapped_file.h"
+
+// Compiles a text level (.lvl) into the binary level format, which loads without any
+// parsing. GameLevel::Load tells the two formats apart by content, so a compiled level
+// can be used wherever a text level is.
+//
+// usage: breakout_levelc <input.lvl> <output>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "usage: breakout_levelc <input.lvl> <output>" << std::endl;
+        return 1;
+    }
+    MappedFile input;
+    if (!input.Open(argv[1]))
+    {
+        std::cout << "ERROR::LEVELC: Failed to read " << argv[1] << std::endl;
+        return 1;
+    }
+    if (IsCompiledLevel(input.Data(), input.Size()))
+    {
+        std::cout << "ERROR::LEVELC: " << argv[1] << " is compiled already" << std::endl;
+        return 1;
+    }
+    LevelTiles tiles;
+    ParseLevelText(reinterpret_cast<const char*>(input.Data()), input.Size(), tiles);
+    if (tiles.Height == 0)
+    {
+        std::cout << "ERROR::LEVELC: No tiles in " << argv[1] << std::endl;
+        return 1;
+    }
+    if (!WriteCompiledLevel(argv[2], tiles))
+    {
+        std::cout << "ERROR::LEVELC: Failed to write " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << argv[2] << ": " << tiles.Width << "x" << tiles.Height << " tiles" << std::endl;
+    return 0;
+}
\ No newline at end of file
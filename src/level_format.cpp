@@ -0,0 +1,123 @@
+#include "level_format.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#define LEVEL_FROM_CHARS
+#endif
+
+
+static std::uint32_t readU32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24); }
+static void writeU32(unsigned char* p, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<unsigned char>(value >> (i * 8));
+}
+
+// parses the digits at text into value; returns the end of the number
+static const char* parseCode(const char* text, const char* end, unsigned int& value)
+{
+#ifdef LEVEL_FROM_CHARS
+    std::from_chars_result result = std::from_chars(text, end, value);
+    if (result.ec == std::errc::result_out_of_range)
+    {   // too big for an unsigned int: clamped below anyway
+        value = 255;
+        while (result.ptr != end && *result.ptr >= '0' && *result.ptr <= '9')
+            ++result.ptr;
+    }
+    return result.ptr;
+#else
+    // what from_chars does for decimal digits (C++14 has no <charconv>)
+    value = 0;
+    for (; text != end && *text >= '0' && *text <= '9'; ++text)
+        value = std::min(value * 10 + static_cast<unsigned int>(*text - '0'), 256u);
+    return text;
+#endif
+}
+
+bool IsCompiledLevel(const unsigned char* data, std::size_t size)
+{
+    return size >= sizeof(LEVEL_MAGIC) && std::memcmp(data, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) == 0;
+}
+
+bool ReadCompiledLevel(const unsigned char* data, std::size_t size, unsigned int& width, unsigned int& height, const unsigned char*& codes)
+{
+    if (size < LEVEL_HEADER_SIZE || readU32(data + 4) != LEVEL_VERSION)
+    {
+        std::cout << "ERROR::LEVEL: Unsupported compiled level version" << std::endl;
+        return false;
+    }
+    width = readU32(data + 8);
+    height = readU32(data + 12);
+    if (width == 0 || height == 0)
+    {
+        std::cout << "ERROR::LEVEL: Compiled level has no tiles" << std::endl;
+        return false;
+    }
+    if (static_cast<unsigned long long>(width) * height > size - LEVEL_HEADER_SIZE)
+    {
+        std::cout << "ERROR::LEVEL: Compiled level is cut short" << std::endl;
+        return false;
+    }
+    codes = data + LEVEL_HEADER_SIZE;
+    return true;
+}
+
+void ParseLevelText(const char* text, std::size_t length, LevelTiles& tiles)
+{
+    tiles.Width = tiles.Height = 0;
+    tiles.Codes.clear();
+    const char* end = text + length;
+    while (text != end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(text, '\n', end - text));
+        if (!lineEnd)
+            lineEnd = end;
+        size_t row = tiles.Codes.size();
+        unsigned int count = 0;
+        for (const char* c = text; c != lineEnd;)
+        {
+            if (*c == ' ' || *c == '\t' || *c == '\r')
+            {
+                ++c;
+                continue;
+            }
+            unsigned int code;
+            const char* next = parseCode(c, lineEnd, code);
+            if (next == c)
+                break; // not a number: the rest of the line is ignored
+            c = next;
+            // the first row decides the width
+            if (tiles.Height == 0 || count < tiles.Width)
+                tiles.Codes.push_back(static_cast<unsigned char>(std::min(code, 255u)));
+            ++count;
+        }
+        if (count > 0)
+        {
+            if (tiles.Height == 0)
+                tiles.Width = count;
+            tiles.Codes.resize(row + tiles.Width, 0);
+            ++tiles.Height;
+        }
+        text = lineEnd == end ? end : lineEnd + 1;
+    }
+}
+
+bool WriteCompiledLevel(const char* file, const LevelTiles& tiles)
+{
+    std::ofstream stream(file, std::ios::binary);
+    unsigned char header[LEVEL_HEADER_SIZE];
+    std::memcpy(header, LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+    writeU32(header + 4, LEVEL_VERSION);
+    writeU32(header + 8, tiles.Width);
+    writeU32(header + 12, tiles.Height);
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!tiles.Codes.empty())
+        stream.write(reinterpret_cast<const char*>(&tiles.Codes[0]), tiles.Codes.size());
+    return static_cast<bool>(stream);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef LEVEL_FORMAT_H
+#define LEVEL_FORMAT_H
+#include <cstddef>
+#include <vector>
+
+
+// Compiled levels start with a LEVEL_HEADER_SIZE byte header: the magic "BLVL", then
+// the format version, width and height as little-endian 32-bit values. The tile codes
+// follow, one byte each, row by row.
+const char         LEVEL_MAGIC[4] = { 'B', 'L', 'V', 'L' };
+const unsigned int LEVEL_VERSION = 1;
+const unsigned int LEVEL_HEADER_SIZE = 16;
+
+// The tile codes of a level, row by row (0 is an empty cell)
+struct LevelTiles {
+    unsigned int               Width, Height;
+    std::vector<unsigned char> Codes;
+};
+
+// whether data holds a compiled level (going by the magic)
+bool IsCompiledLevel(const unsigned char* data, std::size_t size);
+// reads the header of a compiled level; codes points into data. Returns false (and reports
+// why) if the version isn't known, the level is empty or the data is too short for its size
+bool ReadCompiledLevel(const unsigned char* data, std::size_t size, unsigned int& width, unsigned int& height, const unsigned char*& codes);
+// parses a text level: rows of tile codes separated by white space, one row per line.
+// Every row is as wide as the first one (short rows are padded with empty cells), lines
+// without codes are skipped and codes above 255 are stored as 255
+void ParseLevelText(const char* text, std::size_t length, LevelTiles& tiles);
+// writes tiles as a compiled level; returns false if the file can't be written
+bool WriteCompiledLevel(const char* file, const LevelTiles& tiles);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) { }
+#else
+MappedFile::MappedFile() : data(nullptr), size(0), descriptor(-1) { }
+#endif
+
+MappedFile::~MappedFile()
+{
+    this->Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const char* file)
+{
+    this->Close();
+    this->file = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (this->file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(this->file, &size))
+    {
+        this->Close();
+        return false;
+    }
+    this->size = static_cast<std::size_t>(size.QuadPart);
+    if (this->size == 0)
+        return true; // empty files can't be mapped, but there is nothing to read anyway
+    this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->mapping)
+        this->data = static_cast<const unsigned char*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!this->data)
+    {
+        this->Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (this->data)
+        UnmapViewOfFile(this->data);
+    if (this->mapping)
+        CloseHandle(this->mapping);
+    if (this->file != INVALID_HANDLE_VALUE)
+        CloseHandle(this->file);
+    this->data = nullptr;
+    this->size = 0;
+    this->mapping = nullptr;
+    this->file = INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const char* file)
+{
+    this->Close();
+    this->descriptor = open(file, O_RDONLY);
+    if (this->descriptor < 0)
+        return false;
+    struct stat status;
+    if (fstat(this->descriptor, &status) != 0)
+    {
+        this->Close();
+        return false;
+    }
+    this->size = static_cast<std::size_t>(status.st_size);
+    if (this->size == 0)
+        return true; // empty files can't be mapped, but there is nothing to read anyway
+    void* view = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, this->descriptor, 0);
+    if (view == MAP_FAILED)
+    {
+        this->Close();
+        return false;
+    }
+    // the file is read front to back once
+    madvise(view, this->size, MADV_SEQUENTIAL);
+    this->data = static_cast<const unsigned char*>(view);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (this->data)
+        munmap(const_cast<unsigned char*>(this->data), this->size);
+    if (this->descriptor >= 0)
+        close(this->descriptor);
+    this->data = nullptr;
+    this->size = 0;
+    this->descriptor = -1;
+}
+#endif
\ No newline at end of file
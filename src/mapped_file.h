@@ -0,0 +1,32 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstddef>
+
+
+// MappedFile maps a whole file into memory, read-only, so it can be read in place
+// instead of being copied into a buffer first. The mapping lasts until Close or
+// destruction.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    // maps the file; returns false if it can't be opened (an empty file has no data)
+    bool                 Open(const char* file);
+    void                 Close();
+    const unsigned char* Data() const { return this->data; }
+    std::size_t          Size() const { return this->size; }
+private:
+    const unsigned char* data;
+    std::size_t          size;
+#ifdef _WIN32
+    void*                file;    // HANDLE
+    void*                mapping; // HANDLE
+#else
+    int                  descriptor;
+#endif
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "music_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// How long the decoder sleeps when every chunk is full
+const std::chrono::milliseconds MUSIC_IDLE_TIME(2);
+
+
+MusicStream::MusicStream()
+    : chunks(MUSIC_CHUNKS), current(MUSIC_CHUNKS), offset(0), looped(false), step(1.0), position(0.0),
+      window(MUSIC_CHUNK_FRAMES * 2), windowFrames(0), atEnd(false), running(false), ended(false)
+{
+    for (unsigned int i = 0; i < MUSIC_CHUNKS; ++i)
+    {
+        this->chunks[i].Samples.resize(MUSIC_CHUNK_FRAMES * 2);
+        this->chunks[i].Frames = 0;
+        this->emptyChunks.TryPush(i);
+    }
+}
+
+MusicStream::~MusicStream()
+{
+    if (this->running)
+    {
+        this->running = false;
+        this->thread.join();
+    }
+}
+
+bool MusicStream::Open(const char* file, unsigned int rate, bool looped)
+{
+    if (!this->reader.Open(file))
+        return false;
+    // an empty track would loop forever without producing anything
+    this->looped = looped && this->reader.Frames() > 0;
+    this->step = static_cast<double>(this->reader.Rate()) / rate;
+    this->running = true;
+    this->thread = std::thread(&MusicStream::decode, this);
+    return true;
+}
+
+unsigned int MusicStream::Read(float* out, unsigned int frames)
+{
+    unsigned int done = 0;
+    while (done < frames)
+    {
+        if (this->current == MUSIC_CHUNKS && !this->decodedChunks.TryPop(this->current))
+        {
+            this->current = MUSIC_CHUNKS;
+            break; // the decoder hasn't caught up (or the track is over)
+        }
+        const Chunk& chunk = this->chunks[this->current];
+        unsigned int count = std::min(frames - done, chunk.Frames - this->offset);
+        std::memcpy(out + done * 2, &chunk.Samples[this->offset * 2], count * 2 * sizeof(float));
+        done += count;
+        this->offset += count;
+        if (this->offset == chunk.Frames)
+        {   // played: give the chunk back to the decoder
+            this->emptyChunks.TryPush(this->current);
+            this->current = MUSIC_CHUNKS;
+            this->offset = 0;
+        }
+    }
+    return done;
+}
+
+bool MusicStream::Finished()
+{
+    // ended is set after the last chunk is queued, so once it is seen an empty queue means nothing is left
+    return this->ended && this->current == MUSIC_CHUNKS && this->decodedChunks.Empty();
+}
+
+void MusicStream::decode()
+{
+    unsigned int index;
+    while (this->running)
+    {
+        if (!this->emptyChunks.TryPop(index))
+        {
+            std::this_thread::sleep_for(MUSIC_IDLE_TIME);
+            continue;
+        }
+        Chunk& chunk = this->chunks[index];
+        chunk.Frames = this->resample(&chunk.Samples[0], MUSIC_CHUNK_FRAMES);
+        this->decodedChunks.TryPush(index);
+        if (chunk.Frames < MUSIC_CHUNK_FRAMES)
+        {
+            this->ended = true;
+            break;
+        }
+    }
+}
+
+unsigned int MusicStream::resample(float* out, unsigned int frames)
+{
+    // linear interpolation between the source frames, like LoadWav, carried on across
+    // window refills (and from the end of a looped track back to its start)
+    unsigned int done = 0;
+    while (done < frames)
+    {
+        unsigned int index = static_cast<unsigned int>(this->position);
+        if (index + 1 >= this->windowFrames && !this->atEnd)
+        {   // keep the frame we are at (if it was read already), refill the rest of the window
+            unsigned int first = std::min(index, this->windowFrames);
+            unsigned int kept = this->windowFrames - first;
+            std::memmove(&this->window[0], &this->window[first * 2], kept * 2 * sizeof(float));
+            this->position -= first;
+            this->windowFrames = kept;
+            unsigned int space = MUSIC_CHUNK_FRAMES - kept;
+            unsigned int count = this->reader.Read(&this->window[kept * 2], space);
+            if (count == 0 && this->looped)
+            {
+                this->reader.Rewind();
+                count = this->reader.Read(&this->window[kept * 2], space);
+            }
+            this->windowFrames += count;
+            this->atEnd = count == 0;
+            continue;
+        }
+        if (index >= this->windowFrames)
+            break; // end of the track
+        // at the very end the last frame is held
+        unsigned int next = std::min(index + 1, this->windowFrames - 1);
+        float t = static_cast<float>(this->position - index);
+        for (unsigned int side = 0; side < 2; ++side)
+        {
+            float a = this->window[index * 2 + side], b = this->window[next * 2 + side];
+            out[done * 2 + side] = a + (b - a) * t;
+        }
+        this->position += this->step;
+        ++done;
+    }
+    return done;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+#include "wav_file.h"
+
+
+// Frames of music decoded in one go
+const unsigned int MUSIC_CHUNK_FRAMES = 4096;
+// Number of chunks a stream decodes ahead of playback (a power of two)
+const unsigned int MUSIC_CHUNKS = 8;
+
+// MusicStream plays a .wav track without ever holding all of it: a background thread
+// reads and resamples it a chunk at a time into a ring of MUSIC_CHUNKS chunks, keeping
+// ahead of playback, which takes the chunks back once played. Memory use is the same
+// however long the track is, and playback can begin as soon as the first chunk is ready.
+class MusicStream
+{
+public:
+    MusicStream();
+    ~MusicStream();
+    // reads the header of the track and starts decoding it at the given rate; a looped
+    // track goes on from its first frame once it reaches the end, without a gap
+    bool         Open(const char* file, unsigned int rate, bool looped);
+    bool         Looped() const { return this->looped; }
+    // playback side: copies up to frames decoded frames (interleaved stereo) into out and
+    // returns how many there were; fewer than asked only if the decoder is behind or the
+    // track has ended
+    unsigned int Read(float* out, unsigned int frames);
+    // playback side: whether every frame of the track has been read
+    bool         Finished();
+private:
+    struct Chunk {
+        std::vector<float> Samples; // interleaved stereo, MUSIC_CHUNK_FRAMES frames
+        unsigned int       Frames;  // decoded frames (less than a full chunk only at the end)
+    };
+    std::vector<Chunk>                   chunks;
+    SpscRing<unsigned int, MUSIC_CHUNKS> emptyChunks;   // playback -> decoder
+    SpscRing<unsigned int, MUSIC_CHUNKS> decodedChunks; // decoder -> playback
+    // playback state
+    unsigned int       current;  // chunk being read, MUSIC_CHUNKS if none
+    unsigned int       offset;   // next frame of it
+    // decoder state
+    WavReader          reader;
+    bool               looped;
+    double             step;     // source frames per output frame
+    double             position; // of the next output frame, in source frames from the start of the window
+    std::vector<float> window;   // source frames around position
+    unsigned int       windowFrames;
+    bool               atEnd;    // the whole track has been read into the window
+    std::thread        thread;
+    std::atomic<bool>  running;
+    std::atomic<bool>  ended;    // the last chunk has been decoded
+    // decoder thread: fills empty chunks until the track ends or the stream is destroyed
+    void         decode();
+    // resamples the next frames of the track into out; returns how many (fewer at the end)
+    unsigned int resample(float* out, unsigned int frames);
+};
+
+#endif
\ No newline at end of file
@@ -1,50 +1,140 @@
 #include "particle_generator.h"
 
-ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount)
-    : shader(shader), texture(texture), amount(amount)
+#include <cstddef>
+
+// pick the widest vector unit the compiler targets; everything else falls back to the scalar path
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PARTICLE_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLE_LANES 4
+#endif
+
+// Number of particles updated by one job
+const unsigned int PARTICLES_PER_JOB = 1024;
+// Alpha a particle loses per second
+const float PARTICLE_FADE_RATE = 2.5f;
+
+unsigned int PackParticleColor(glm::vec4 color)
 {
-    this->init();
+    glm::vec4 scaled = glm::clamp(color / glm::vec4(glm::vec3(PARTICLE_TINT_SCALE), 1.0f), 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<unsigned int>(scaled.r) | static_cast<unsigned int>(scaled.g) << 8 |
+           static_cast<unsigned int>(scaled.b) << 16 | static_cast<unsigned int>(scaled.a) << 24;
 }
 
-void ParticleGenerator::Update(float dt, GameObject& object, unsigned int newParticles, glm::vec2 offset)
+void IntegrateParticles(ParticleStore& particles, unsigned int first, unsigned int last, float dt)
 {
-    // add new particles 
-    for (unsigned int i = 0; i < newParticles; ++i)
+    if (first >= last) // nothing to do (and an empty store has no arrays to point into)
+        return;
+    const float fade = dt * PARTICLE_FADE_RATE;
+    float* x = &particles.X[0], * y = &particles.Y[0];
+    float* previousX = &particles.PreviousX[0], * previousY = &particles.PreviousY[0];
+    const float* velocityX = &particles.VelocityX[0], * velocityY = &particles.VelocityY[0];
+    float* life = &particles.Life[0], * alpha = &particles.Alpha[0];
+    unsigned int i = first;
+#if PARTICLE_LANES == 8
+    const __m256 step = _mm256_set1_ps(dt), fadeStep = _mm256_set1_ps(fade);
+    for (; i + PARTICLE_LANES <= last; i += PARTICLE_LANES)
+    {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i);
+        _mm256_storeu_ps(previousX + i, px);
+        _mm256_storeu_ps(previousY + i, py);
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(px, _mm256_mul_ps(_mm256_loadu_ps(velocityX + i), step)));
+        _mm256_storeu_ps(y + i, _mm256_sub_ps(py, _mm256_mul_ps(_mm256_loadu_ps(velocityY + i), step)));
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), step));
+        _mm256_storeu_ps(alpha + i, _mm256_sub_ps(_mm256_loadu_ps(alpha + i), fadeStep));
+    }
+#elif PARTICLE_LANES == 4
+    const __m128 step = _mm_set1_ps(dt), fadeStep = _mm_set1_ps(fade);
+    for (; i + PARTICLE_LANES <= last; i += PARTICLE_LANES)
     {
-        int unusedParticle = this->firstUnusedParticle();
-        this->respawnParticle(this->particles[unusedParticle], object, offset);
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(previousX + i, px);
+        _mm_storeu_ps(previousY + i, py);
+        _mm_storeu_ps(x + i, _mm_sub_ps(px, _mm_mul_ps(_mm_loadu_ps(velocityX + i), step)));
+        _mm_storeu_ps(y + i, _mm_sub_ps(py, _mm_mul_ps(_mm_loadu_ps(velocityY + i), step)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), step));
+        _mm_storeu_ps(alpha + i, _mm_sub_ps(_mm_loadu_ps(alpha + i), fadeStep));
     }
-    // update all particles
-    for (unsigned int i = 0; i < this->amount; ++i)
+#endif
+    // remaining particles (or all of them without vector support)
+    for (; i < last; ++i)
+    {
+        previousX[i] = x[i];
+        previousY[i] = y[i];
+        x[i] -= velocityX[i] * dt;
+        y[i] -= velocityY[i] * dt;
+        life[i] -= dt;
+        alpha[i] -= fade;
+    }
+}
+
+ParticleGenerator::ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, StreamBuffer* stream, JobSystem* jobs)
+    : recycle(0), jobs(jobs), random(DEFAULT_SEED, STREAM_COSMETIC), shader(shader), texture(texture), stream(stream)
+{
+    this->particles.Resize(amount);
+    this->init();
+}
+
+void ParticleGenerator::Update(float dt, GameObject& object, unsigned int newParticles, glm::vec2 offset)
+{
+    // add new particles
+    if (this->particles.Capacity() > 0)
+        for (unsigned int i = 0; i < newParticles; ++i)
+            this->respawnParticle(this->spawnSlot(), object, offset);
+    // update the live particles
+    unsigned int live = this->particles.Live;
+    auto update = [this, dt](unsigned int first, unsigned int last) {
+        IntegrateParticles(this->particles, first, last, dt);
+    };
+    if (this->jobs)
+        this->jobs->Wait(this->jobs->ParallelFor(0, live, PARTICLES_PER_JOB, update));
+    else
+        update(0, live);
+    // then drop the ones that died, keeping the live ones packed at the front
+    for (unsigned int i = 0; i < this->particles.Live;)
     {
-        Particle& p = this->particles[i];
-        p.Life -= dt; // reduce life
-        if (p.Life > 0.0f)
-        {	// particle is alive, thus update
-            p.Position -= p.Velocity * dt;
-            p.Color.a -= dt * 2.5f;
-        }
+        if (this->particles.Life[i] <= 0.0f)
+            this->particles.Remove(i);
+        else
+            ++i;
     }
 }
 
 // render all particles
-void ParticleGenerator::Draw()
+void ParticleGenerator::Draw(float alpha)
 {
+    const ParticleStore& p = this->particles;
+    if (p.Live == 0)
+        return;
+    // write the visible particles straight into the stream buffer (the tail of a particle's life has faded out)
+    ParticleInstance* instances = static_cast<ParticleInstance*>(this->stream->Map(p.Live * sizeof(ParticleInstance)));
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < p.Live; ++i)
+    {
+        if (p.Alpha[i] <= 0.0f)
+            continue;
+        unsigned int fade = static_cast<unsigned int>(std::min(p.Alpha[i], 1.0f) * 255.0f + 0.5f);
+        instances[visible].Offset = glm::vec2(glm::mix(p.PreviousX[i], p.X[i], alpha), glm::mix(p.PreviousY[i], p.Y[i], alpha));
+        instances[visible].Color = (p.Tint[i] & 0x00FFFFFFu) | fade << 24;
+        ++visible;
+    }
+    size_t offset = this->stream->Unmap();
+    if (visible == 0)
+        return;
+
     // use additive blending to give it a 'glow' effect
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     this->shader.Use();
-    for (Particle particle : this->particles)
-    {
-        if (particle.Life > 0.0f)
-        {
-            this->shader.SetVector2f("offset", particle.Position);
-            this->shader.SetVector4f("color", particle.Color);
-            this->texture.Bind();
-            glBindVertexArray(this->VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glBindVertexArray(0);
-        }
-    }
+    glActiveTexture(GL_TEXTURE0);
+    this->texture.Bind();
+    glBindVertexArray(this->VAO);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Offset)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance), (void*)(offset + offsetof(ParticleInstance, Color)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, visible);
+    glBindVertexArray(0);
     // don't forget to reset to default blending mode
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
@@ -71,42 +161,38 @@ void ParticleGenerator::init()
     // set mesh attributes
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    // per particle: offset, color (pointed into the stream buffer by Draw)
+    for (unsigned int attribute = 1; attribute <= 2; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-
-    // create this->amount default particle instances
-    for (unsigned int i = 0; i < this->amount; ++i)
-        this->particles.push_back(Particle());
 }
 
-// stores the index of the last particle used (for quick access to next dead particle)
-unsigned int lastUsedParticle = 0;
-unsigned int ParticleGenerator::firstUnusedParticle()
+unsigned int ParticleGenerator::spawnSlot()
 {
-    // first search from last used particle, this will usually return almost instantly
-    for (unsigned int i = lastUsedParticle; i < this->amount; ++i) {
-        if (this->particles[i].Life <= 0.0f) {
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    // otherwise, do a linear search
-    for (unsigned int i = 0; i < lastUsedParticle; ++i) {
-        if (this->particles[i].Life <= 0.0f) {
-            lastUsedParticle = i;
-            return i;
-        }
-    }
-    // all particles are taken, override the first one (note that if it repeatedly hits this case, more particles should be reserved)
-    lastUsedParticle = 0;
-    return 0;
+    // the dead particles are all past the live ones
+    if (this->particles.Live < this->particles.Capacity())
+        return this->particles.Live++;
+    // all particles are taken, take over live ones in turn (note that if it repeatedly hits this case, more particles should be reserved)
+    unsigned int i = this->recycle;
+    this->recycle = (this->recycle + 1) % this->particles.Capacity();
+    return i;
 }
 
-void ParticleGenerator::respawnParticle(Particle& particle, GameObject& object, glm::vec2 offset)
+void ParticleGenerator::respawnParticle(unsigned int i, GameObject& object, glm::vec2 offset)
 {
-    float random = ((rand() % 100) - 50) / 10.0f;
-    float rColor = 0.5f + ((rand() % 100) / 100.0f);
-    particle.Position = object.Position + random + offset;
-    particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
-    particle.Life = 1.0f;
-    particle.Velocity = object.Velocity * 0.1f;
+    float random = (static_cast<int>(this->random.NextBelow(100)) - 50) / 10.0f;
+    float rColor = 0.5f + (this->random.NextBelow(100) / 100.0f);
+    glm::vec2 position = object.Position + random + offset;
+    ParticleStore& p = this->particles;
+    p.X[i] = p.PreviousX[i] = position.x;
+    p.Y[i] = p.PreviousY[i] = position.y;
+    p.VelocityX[i] = object.Velocity.x * 0.1f;
+    p.VelocityY[i] = object.Velocity.y * 0.1f;
+    p.Tint[i] = PackParticleColor(glm::vec4(rColor, rColor, rColor, 1.0f));
+    p.Alpha[i] = 1.0f;
+    p.Life[i] = 1.0f;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #ifndef PARTICLE_GENERATOR_H
 #define PARTICLE_GENERATOR_H
+#include <algorithm>
 #include <vector>
 
 #include <glad/glad.h>
@@ -7,45 +8,93 @@
 
 #include "shader.h"
 #include "texture.h"
+#include "stream_buffer.h"
 #include "game_object.h"
+#include "job_system.h"
+#include "random.h"
 
 
-// Represents a single particle and its state
-struct Particle {
-    glm::vec2 Position, Velocity;
-    glm::vec4 Color;
-    float     Life;
+// Particle tints are stored as RGBA8 divided by this, so tints brighter than white still fit
+// in a byte (the particle shader multiplies them back)
+const float PARTICLE_TINT_SCALE = 2.0f;
 
-    Particle() : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) { }
+// Packs a particle tint (rgb up to PARTICLE_TINT_SCALE, alpha up to 1) into RGBA8, red in the lowest byte
+unsigned int PackParticleColor(glm::vec4 color);
+
+// ParticleStore keeps the particles of one generator as parallel arrays (structure of
+// arrays), sized for all particles up front. The first Live entries are the live particles;
+// a particle that dies is removed by swapping the last live particle into its slot, so
+// updating and drawing only ever touch live particles.
+struct ParticleStore {
+    std::vector<float>        X, Y;                 // current position
+    std::vector<float>        PreviousX, PreviousY; // position at the start of the current simulation step
+    std::vector<float>        VelocityX, VelocityY;
+    std::vector<float>        Life;                 // seconds left
+    std::vector<float>        Alpha;                // fades out over the particle's life
+    std::vector<unsigned int> Tint;                 // PackParticleColor (its alpha byte is replaced by Alpha when drawn)
+    unsigned int              Live;
+
+    ParticleStore() : Live(0) { }
+    unsigned int Capacity() const { return static_cast<unsigned int>(this->X.size()); }
+    void Resize(unsigned int capacity)
+    {
+        X.resize(capacity); Y.resize(capacity); PreviousX.resize(capacity); PreviousY.resize(capacity);
+        VelocityX.resize(capacity); VelocityY.resize(capacity); Life.resize(capacity); Alpha.resize(capacity); Tint.resize(capacity);
+        Live = std::min(Live, capacity);
+    }
+    // removes a live particle by moving the last live particle into its slot
+    void Remove(unsigned int i)
+    {
+        unsigned int last = --this->Live;
+        X[i] = X[last]; Y[i] = Y[last];
+        PreviousX[i] = PreviousX[last]; PreviousY[i] = PreviousY[last];
+        VelocityX[i] = VelocityX[last]; VelocityY[i] = VelocityY[last];
+        Life[i] = Life[last]; Alpha[i] = Alpha[last]; Tint[i] = Tint[last];
+    }
 };
 
+// Per-instance data of a drawn particle, as the particle shader reads it
+struct ParticleInstance {
+    glm::vec2    Offset;
+    unsigned int Color; // RGBA8, see PackParticleColor
+};
+
+// moves the particles in [first, last) by their velocity over dt, ages them and fades them out, several
+// particles at a time (SSE2/AVX2 where available). Disjoint ranges can be updated on different threads.
+void IntegrateParticles(ParticleStore& particles, unsigned int first, unsigned int last, float dt);
+
 
-// ParticleGenerator acts as a container for rendering a large number of 
-// particles by repeatedly spawning and updating particles and killing 
+// ParticleGenerator acts as a container for rendering a large number of
+// particles by repeatedly spawning and updating particles and killing
 // them after a given amount of time.
 class ParticleGenerator
 {
 public:
-    // constructor
-    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
-    // update all particles
+    // constructor; the live particles are written to stream when drawn
+    ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount, StreamBuffer* stream, JobSystem* jobs = nullptr);
+    // spawns newParticles particles at the object, then updates all live particles
     void Update(float dt, GameObject& object, unsigned int newParticles, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
-    // render all particles
-    void Draw();
+    // render all visible particles with one instanced draw, interpolated between their previous and current position by alpha
+    void Draw(float alpha = 1.0f);
+    // number of live particles
+    unsigned int Live() const { return this->particles.Live; }
 private:
     // state
-    std::vector<Particle> particles;
-    unsigned int amount;
+    ParticleStore particles;
+    unsigned int recycle; // next particle to take over when all of them are alive
+    JobSystem* jobs;      // updates the particles in parallel (if set)
+    Random random;        // cosmetic stream, so particles never change how a game plays out
     // render state
     Shader shader;
     Texture2D texture;
+    StreamBuffer* stream;
     unsigned int VAO;
     // initializes buffer and vertex attributes
     void init();
-    // returns the first Particle index that's currently unused e.g. Life <= 0.0f or 0 if no particle is currently inactive
-    unsigned int firstUnusedParticle();
-    // respawns particle
-    void respawnParticle(Particle& particle, GameObject& object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
+    // returns the slot for a new particle: the first dead one, or (when all are alive) a live one in turn
+    unsigned int spawnSlot();
+    // spawns a particle into slot i
+    void respawnParticle(unsigned int i, GameObject& object, glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "power_up.h"
+
+#include "simulation.h"
+
+
+static void activateSpeed(Simulation& world)
+{
+    for (unsigned int i = 0; i < world.Balls.Count(); ++i)
+    {
+        world.Balls.VelocityX[i] *= 1.2f;
+        world.Balls.VelocityY[i] *= 1.2f;
+    }
+}
+
+static void activateSticky(Simulation& world)
+{
+    for (unsigned char& flags : world.Balls.Flags)
+        flags |= BALL_STICKY;
+    world.Player.Color = glm::vec3(1.0f, 0.5f, 1.0f);
+}
+
+static void deactivateSticky(Simulation& world)
+{
+    for (unsigned char& flags : world.Balls.Flags)
+        flags &= ~BALL_STICKY;
+    world.Player.Color = glm::vec3(1.0f);
+}
+
+static void activatePassThrough(Simulation& world)
+{
+    for (unsigned int i = 0; i < world.Balls.Count(); ++i)
+    {
+        world.Balls.Flags[i] |= BALL_PASS_THROUGH;
+        world.Balls.Color[i] = glm::vec3(1.0f, 0.5f, 0.5f);
+    }
+}
+
+static void deactivatePassThrough(Simulation& world)
+{
+    for (unsigned int i = 0; i < world.Balls.Count(); ++i)
+    {
+        world.Balls.Flags[i] &= ~BALL_PASS_THROUGH;
+        world.Balls.Color[i] = glm::vec3(1.0f);
+    }
+}
+
+static void activatePadSizeIncrease(Simulation& world)
+{
+    world.Player.Size.x += 50;
+}
+
+static void activateConfuse(Simulation& world)
+{
+    if (!world.Chaos)
+        world.Confuse = true; // only activate if chaos wasn't already active
+}
+
+static void deactivateConfuse(Simulation& world)
+{
+    world.Confuse = false;
+}
+
+static void activateChaos(Simulation& world)
+{
+    if (!world.Confuse)
+        world.Chaos = true;
+}
+
+static void deactivateChaos(Simulation& world)
+{
+    world.Chaos = false;
+}
+
+//Power_Up extra
+static void activateSplit(Simulation& world)
+{
+    //check if already are more than one ball in the vector
+    if (world.Balls.Count() >= 2)
+        return;
+    //else create the balls
+    world.Split = true;
+
+    //the current position of the player
+    glm::vec2 ballPos = world.Player.Position + glm::vec2(world.Player.Size.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+    for (int i = 0; i < 2; ++i)
+    {
+        //set new velocity
+        glm::vec2 velocity = (i == 0)
+            ? glm::vec2(-INITIAL_BALL_VELOCITY.x, INITIAL_BALL_VELOCITY.y)
+            : glm::vec2(INITIAL_BALL_VELOCITY.x, INITIAL_BALL_VELOCITY.y);
+        //add one ball
+        unsigned int ball = world.Balls.Add(ballPos, BALL_RADIUS, velocity);
+        world.Balls.Color[ball] = glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+}
+
+static void deactivateSplit(Simulation& world)
+{
+    if (world.Balls.Count() == 1)
+        world.Split = false;
+}
+
+// Negative powerups spawn more often
+const PowerUpInfo POWERUP_TYPES[POWERUP_TYPE_COUNT] = {
+    // name                 texture                 color                           duration  1 in   activate                  deactivate
+    { "speed",              "powerup_speed",        glm::vec3(0.5f, 0.5f, 1.0f),    0.0f,     75,    activateSpeed,            nullptr },
+    { "sticky",             "powerup_sticky",       glm::vec3(1.0f, 0.5f, 1.0f),    20.0f,    75,    activateSticky,           deactivateSticky },
+    { "pass-through",       "powerup_passthrough",  glm::vec3(0.5f, 1.0f, 0.5f),    10.0f,    75,    activatePassThrough,      deactivatePassThrough },
+    { "pad-size-increase",  "powerup_increase",     glm::vec3(1.0f, 0.6f, 0.4f),    0.0f,     75,    activatePadSizeIncrease,  nullptr },
+    { "confuse",            "powerup_confuse",      glm::vec3(1.0f, 0.3f, 0.3f),    15.0f,    15,    activateConfuse,          deactivateConfuse },
+    { "chaos",              "powerup_chaos",        glm::vec3(0.9f, 0.25f, 0.25f),  15.0f,    15,    activateChaos,            deactivateChaos },
+    { "split",              "powerup_split",        glm::vec3(0.0f, 0.5f, 1.0f),    0.0f,     30,    activateSplit,            deactivateSplit }
+};
+
+PickupPool::PickupPool()
+    : X(CAPACITY), Y(CAPACITY), PreviousX(CAPACITY), PreviousY(CAPACITY), Type(CAPACITY),
+      slots(CAPACITY), owners(CAPACITY), count(0), freeSlot(0)
+{
+    this->Clear();
+}
+
+PickupHandle PickupPool::Spawn(PowerUpType type, glm::vec2 position)
+{
+    if (this->count == CAPACITY)
+        return PickupHandle();
+    unsigned int slot = this->freeSlot;
+    Slot& entry = this->slots[slot];
+    this->freeSlot = entry.Index;
+    ++entry.Generation;
+    entry.Index = this->count;
+    unsigned int i = this->count++;
+    this->X[i] = this->PreviousX[i] = position.x;
+    this->Y[i] = this->PreviousY[i] = position.y;
+    this->Type[i] = type;
+    this->owners[i] = slot;
+    return PickupHandle(slot, entry.Generation);
+}
+
+void PickupPool::Remove(unsigned int i)
+{
+    unsigned int slot = this->owners[i], last = --this->count;
+    // move the last pickup into the gap
+    this->X[i] = this->X[last]; this->Y[i] = this->Y[last];
+    this->PreviousX[i] = this->PreviousX[last]; this->PreviousY[i] = this->PreviousY[last];
+    this->Type[i] = this->Type[last];
+    this->owners[i] = this->owners[last];
+    this->slots[this->owners[i]].Index = i;
+    // and retire the slot; bumping the generation invalidates its handles
+    ++this->slots[slot].Generation;
+    this->slots[slot].Index = this->freeSlot;
+    this->freeSlot = slot;
+}
+
+void PickupPool::Clear()
+{
+    for (unsigned int i = 0; i < this->count; ++i)
+        ++this->slots[this->owners[i]].Generation;
+    this->count = 0;
+    // chain all slots into the free list, lowest first
+    for (unsigned int slot = 0; slot < CAPACITY; ++slot)
+        this->slots[slot].Index = slot + 1;
+    this->freeSlot = 0;
+}
+
+PickupHandle PickupPool::Handle(unsigned int i) const
+{
+    unsigned int slot = this->owners[i];
+    return PickupHandle(slot, this->slots[slot].Generation);
+}
+
+bool PickupPool::Find(PickupHandle handle, unsigned int& i) const
+{
+    if (handle.Index >= CAPACITY || this->slots[handle.Index].Generation != handle.Generation || !(handle.Generation & 1))
+        return false;
+    i = this->slots[handle.Index].Index;
+    return true;
+}
\ No newline at end of file
@@ -1,33 +1,89 @@
 #ifndef POWER_UP_H
 #define POWER_UP_H
-#include <string>
+#include <vector>
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include "game_object.h"
-
 
 // The size of a PowerUp block
 const glm::vec2 POWERUP_SIZE(60.0f, 20.0f);
 // Velocity a PowerUp block has when spawned
 const glm::vec2 VELOCITY(0.0f, 150.0f);
 
+class Simulation;
+
+// The kinds of PowerUp; each one indexes its entry in POWERUP_TYPES
+enum PowerUpType {
+    POWERUP_SPEED,
+    POWERUP_STICKY,
+    POWERUP_PASS_THROUGH,
+    POWERUP_PAD_SIZE_INCREASE,
+    POWERUP_CONFUSE,
+    POWERUP_CHAOS,
+    POWERUP_SPLIT,
+    POWERUP_TYPE_COUNT
+};
+
+// Everything that sets one kind of PowerUp apart
+struct PowerUpInfo {
+    const char*  Name;
+    const char*  Texture;     // name of its sprite in the ResourceManager
+    glm::vec3    Color;
+    float        Duration;    // seconds the effect lasts (0 = it ends with the step it was picked up in)
+    unsigned int SpawnChance; // on average 1 in SpawnChance destroyed bricks drops one
+    // apply/undo the effect; Deactivate (if any) runs once the last active PowerUp of the kind expires
+    void (*Activate)(Simulation& world);
+    void (*Deactivate)(Simulation& world);
+};
+
+// The PowerUp table, indexed by PowerUpType
+extern const PowerUpInfo POWERUP_TYPES[POWERUP_TYPE_COUNT];
+
+
+// Refers to a pickup in a PickupPool. A handle stays valid until its pickup is
+// removed; after that (even once the slot is reused) it no longer finds anything.
+struct PickupHandle {
+    unsigned int Index;
+    unsigned int Generation;
+
+    PickupHandle() : Index(0), Generation(0) { }
+    PickupHandle(unsigned int index, unsigned int generation) : Index(index), Generation(generation) { }
+};
 
-// PowerUp inherits its state and rendering functions from
-// GameObject but also holds extra information to state its
-// active duration and whether it is activated or not. 
-// The type of PowerUp is stored as a string.
-class PowerUp : public GameObject
+// PickupPool holds the PowerUp pickups falling down the screen. The live pickups are
+// packed at the front of parallel arrays ([0, Count)), so they can be moved as one dense
+// block; removing one swaps the last pickup into its place. All storage is allocated up
+// front, so spawning and removing pickups never allocates.
+class PickupPool
 {
 public:
-    // powerup state
-    std::string Type;
-    float       Duration;
-    bool        Activated;
+    // maximum number of pickups falling at once (spawns beyond that are dropped)
+    static const unsigned int CAPACITY = 1024;
+    std::vector<float>       X, Y;                 // top-left corner
+    std::vector<float>       PreviousX, PreviousY; // position at the start of the current simulation step
+    std::vector<PowerUpType> Type;
     // constructor
-    PowerUp(std::string type, glm::vec3 color, float duration, glm::vec2 position, Texture2D texture)
-        : GameObject(position, POWERUP_SIZE, texture, color, VELOCITY), Type(type), Duration(duration), Activated() { }
+    PickupPool();
+    unsigned int Count() const { return this->count; }
+    glm::vec2    Position(unsigned int i) const { return glm::vec2(this->X[i], this->Y[i]); }
+    glm::vec2    PreviousPosition(unsigned int i) const { return glm::vec2(this->PreviousX[i], this->PreviousY[i]); }
+    // adds a pickup; returns a default (invalid) handle if the pool is full
+    PickupHandle Spawn(PowerUpType type, glm::vec2 position);
+    // removes the pickup at index i by moving the last one into its place
+    void         Remove(unsigned int i);
+    void         Clear();
+    // the handle of the pickup at index i, and the index of the pickup a handle refers to (false if it's gone)
+    PickupHandle Handle(unsigned int i) const;
+    bool         Find(PickupHandle handle, unsigned int& i) const;
+private:
+    struct Slot {
+        unsigned int Generation; // odd while in use
+        unsigned int Index;      // where its pickup is in the arrays, or the next free slot
+    };
+    std::vector<Slot>         slots;
+    std::vector<unsigned int> owners; // slot of each pickup in the arrays
+    unsigned int              count;
+    unsigned int              freeSlot;
 };
 
 #endif
\ No newline at end of file
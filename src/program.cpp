@@ -14,6 +14,8 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 const unsigned int SCREEN_WIDTH = 800;
 // The height of the screen
 const unsigned int SCREEN_HEIGHT = 600;
+// The longest frame the simulation catches up on at once (keeps a long stall from spiralling)
+const float MAX_FRAME_TIME = 0.25f;
 
 Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
 
@@ -30,6 +32,8 @@ int main(int argc, char* argv[])
 
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Breakout", nullptr, nullptr);
     glfwMakeContextCurrent(window);
+    // the simulation runs at a fixed rate, so rendering doesn't need to wait for vsync
+    glfwSwapInterval(0);
 
     // glad: load all OpenGL function pointers
     // ---------------------------------------
@@ -54,31 +58,36 @@ int main(int argc, char* argv[])
 
     // deltaTime variables
     // -------------------
-    float deltaTime = 0.0f;
-    float lastFrame = 0.0f;
+    double lastFrame = glfwGetTime();
+    float accumulator = 0.0f;
 
     while (!glfwWindowShouldClose(window))
     {
         // calculate delta time
         // --------------------
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        double currentFrame = glfwGetTime();
+        float deltaTime = static_cast<float>(currentFrame - lastFrame);
         lastFrame = currentFrame;
+        accumulator += deltaTime < MAX_FRAME_TIME ? deltaTime : MAX_FRAME_TIME;
         glfwPollEvents();
 
-        // manage user input
-        // -----------------
-        Breakout.ProcessInput(deltaTime);
-
-        // update game state
-        // -----------------
-        Breakout.Update(deltaTime);
+        // advance the simulation in fixed steps for as much time as has passed
+        // --------------------------------------------------------------------
+        while (accumulator >= SIMULATION_STEP)
+        {
+            Breakout.BeginStep();
+            // manage user input
+            Breakout.ProcessInput(SIMULATION_STEP);
+            // update game state
+            Breakout.Update(SIMULATION_STEP);
+            accumulator -= SIMULATION_STEP;
+        }
 
-        // render
-        // ------
+        // render, blending between the last two simulation steps
+        // ------------------------------------------------------
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
-        Breakout.Render();
+        Breakout.Render(accumulator / SIMULATION_STEP);
 
         glfwSwapBuffers(window);
     }
@@ -0,0 +1,69 @@
+#include "random.h"
+
+
+Random::Random(std::uint64_t seed, RandomStream stream)
+{
+    this->Seed(seed, stream);
+}
+
+void Random::Seed(std::uint64_t seed, RandomStream stream)
+{
+    // every stream gets its own (odd) increment, so the sequences never overlap
+    this->state = 0;
+    this->increment = (static_cast<std::uint64_t>(stream) << 1) | 1u;
+    this->Next();
+    this->state += seed;
+    this->Next();
+}
+
+std::uint32_t Random::Next()
+{
+    std::uint64_t old = this->state;
+    this->state = old * 6364136223846793005ull + this->increment;
+    std::uint32_t shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+    std::uint32_t rotation = static_cast<std::uint32_t>(old >> 59);
+    return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+}
+
+void AliasTable::Build(const std::vector<float>& weights)
+{
+    unsigned int count = static_cast<unsigned int>(weights.size());
+    double total = 0.0;
+    for (float weight : weights)
+        total += weight;
+    // scale the weights so the average column is exactly full (1.0), then let every
+    // overfull column top up an underfull one
+    std::vector<double> scaled(count);
+    std::vector<unsigned int> small, large;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        scaled[i] = weights[i] * count / total;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    this->threshold.assign(count, 1ull << 32);
+    this->alias.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+        this->alias[i] = i;
+    while (!small.empty() && !large.empty())
+    {
+        unsigned int less = small.back(), more = large.back();
+        small.pop_back();
+        this->threshold[less] = static_cast<std::uint64_t>(scaled[less] * 4294967296.0);
+        this->alias[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // whatever is left is full up to rounding errors and keeps its own outcome
+}
+
+unsigned int AliasTable::Sample(Random& random) const
+{
+    // the high half of n * x picks the column, the low half decides between the column and its alias
+    std::uint64_t draw = static_cast<std::uint64_t>(random.Next()) * this->alias.size();
+    unsigned int column = static_cast<unsigned int>(draw >> 32);
+    return (draw & 0xFFFFFFFFull) < this->threshold[column] ? column : this->alias[column];
+}
\ No newline at end of file
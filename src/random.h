@@ -0,0 +1,51 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cstdint>
+#include <vector>
+
+
+// The independent random streams; gameplay and cosmetic effects draw from
+// different streams so that e.g. particles never change the outcome of a game
+enum RandomStream {
+    STREAM_GAMEPLAY,
+    STREAM_COSMETIC
+};
+
+// Seed every stream starts from unless told otherwise
+const std::uint64_t DEFAULT_SEED = 0x853c49e6748fea9bull;
+
+// Random is a small, fast, seedable random number generator (PCG32). Two generators
+// with the same seed and stream produce the same numbers on every platform.
+class Random
+{
+public:
+    // constructor
+    explicit Random(std::uint64_t seed = DEFAULT_SEED, RandomStream stream = STREAM_GAMEPLAY);
+    // restarts the sequence
+    void          Seed(std::uint64_t seed, RandomStream stream);
+    // uniform in [0, 2^32)
+    std::uint32_t Next();
+    // uniform in [0, bound)
+    std::uint32_t NextBelow(std::uint32_t bound) { return static_cast<std::uint32_t>((static_cast<std::uint64_t>(this->Next()) * bound) >> 32); }
+    // uniform in [0, 1)
+    float         NextFloat() { return (this->Next() >> 8) * (1.0f / 16777216.0f); }
+private:
+    std::uint64_t state;
+    std::uint64_t increment;
+};
+
+// AliasTable picks one of n outcomes with given weights in constant time (Vose's alias
+// method): Build does the O(n) setup, then every Sample costs a single random number.
+class AliasTable
+{
+public:
+    // sets up the table; the weights don't need to add up to one
+    void         Build(const std::vector<float>& weights);
+    unsigned int Sample(Random& random) const;
+    unsigned int Count() const { return static_cast<unsigned int>(this->alias.size()); }
+private:
+    std::vector<std::uint64_t> threshold; // chance (scaled to 2^32) that a column keeps its own outcome
+    std::vector<unsigned int>  alias;     // the outcome a column gives otherwise
+};
+
+#endif
\ No newline at end of file
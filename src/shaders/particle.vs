@@ -1,17 +1,18 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+// per particle
+layout (location = 1) in vec2 offset;
+layout (location = 2) in vec4 color; // RGBA8, rgb divided by the tint scale
 
 out vec2 TexCoords;
 out vec4 ParticleColor;
 
 uniform mat4 projection;
-uniform vec2 offset;
-uniform vec4 color;
 
 void main()
 {
     float scale = 10.0f;
     TexCoords = vertex.zw;
-    ParticleColor = color;
+    ParticleColor = vec4(color.rgb * 2.0, color.a); // PARTICLE_TINT_SCALE
     gl_Position = projection * vec4((vertex.xy * scale) + offset, 0.0, 1.0);
 }
\ No newline at end of file
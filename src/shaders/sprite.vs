@@ -1,13 +1,22 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+// per sprite
+layout (location = 1) in vec4 bounds; // <vec2 position, vec2 size>
+layout (location = 2) in vec4 tint;   // <vec3 color, float rotation (radians)>
+layout (location = 3) in vec4 uv;     // <vec2 offset, vec2 size> of the part of the texture shown
 
 out vec2 TexCoords;
+out vec3 SpriteColor;
 
-uniform mat4 model;
 uniform mat4 projection;
 
 void main()
 {
-    TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+    TexCoords = uv.xy + vertex.zw * uv.zw;
+    SpriteColor = tint.rgb;
+    // scale, rotate around the center of the quad, then move it into place
+    vec2 local = (vertex.xy - 0.5) * bounds.zw;
+    float c = cos(tint.w), s = sin(tint.w);
+    vec2 rotated = vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    gl_Position = projection * vec4(bounds.xy + 0.5 * bounds.zw + rotated, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,657 @@
+#include "simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+Simulation::Simulation(unsigned int width, unsigned int height)
+    : State(GAME_MENU), Split(false), Countdown(COUNTDOWN_START), Width(width), Height(height), Catalog(width, height / 2),
+      Player(glm::vec2(width / 2.0f - PLAYER_SIZE.x / 2.0f, height - PLAYER_SIZE.y), PLAYER_SIZE),
+      Level(0), Lives(3), ExtraLifeCounter(BLOCK_COUNT_LIFES), Confuse(false), Chaos(false), Timers(EFFECT_COUNT), Jobs(nullptr), Dice(DEFAULT_SEED, STREAM_GAMEPLAY)
+{
+    // every kind drops as often as its SpawnChance says, a brick drops nothing the rest of the time
+    std::vector<float> weights;
+    float total = 0.0f;
+    for (unsigned int type = 0; type < POWERUP_TYPE_COUNT; ++type)
+    {
+        weights.push_back(1.0f / POWERUP_TYPES[type].SpawnChance);
+        total += weights.back();
+    }
+    weights.push_back(std::max(1.0f - total, 0.0f));
+    this->PowerUpDrops.Build(weights);
+}
+
+void Simulation::Seed(std::uint64_t seed)
+{
+    this->Dice.Seed(seed, STREAM_GAMEPLAY);
+}
+
+void Simulation::LoadLevels(const std::string& directory)
+{
+    // only the first level is loaded now; the others as they come up
+    this->Catalog.Discover(directory);
+    this->Level = 0;
+    this->useLevel();
+
+    // configure game objects
+    glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    this->Player = GameObject(playerPos, PLAYER_SIZE);
+    glm::vec2 ballPos = playerPos + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+    Balls.Clear(); // make sure it's empty
+    Balls.Add(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY);
+
+    this->Countdown = COUNTDOWN_START;  //starts the countdown
+    this->ExtraLifeCounter = BLOCK_COUNT_LIFES; // Restars the conter fr the extra life
+}
+
+void Simulation::Subscribe(SimulationListener* listener)
+{
+    this->listeners.push_back(listener);
+}
+
+void Simulation::Start()
+{
+    if (this->State == GAME_MENU)
+        this->State = GAME_ACTIVE;
+}
+
+void Simulation::SelectLevel(int step)
+{
+    int count = static_cast<int>(this->Catalog.Count());
+    if (count == 0)
+        return;
+    this->Level = static_cast<unsigned int>(((static_cast<int>(this->Level) + step) % count + count) % count);
+    this->useLevel();
+}
+
+void Simulation::useLevel()
+{
+    if (this->Catalog.Count() == 0)
+    {
+        this->pristine.reset();
+        this->Current = GameLevel();
+        return;
+    }
+    // ready already if it was prefetched
+    this->pristine = this->Catalog.Get(this->Level);
+    this->Current = *this->pristine;
+    this->Catalog.Prefetch(this->Level);
+}
+
+void Simulation::ReturnToMenu()
+{
+    this->Chaos = false;
+    this->State = GAME_MENU;
+}
+
+void Simulation::MovePaddle(float direction, float dt)
+{
+    float velocity = PLAYER_VELOCITY * dt;
+    // move playerboard (stuck balls move along with it)
+    if (direction < 0.0f)
+    {
+        if (this->Player.Position.x >= 0.0f)
+        {
+            this->Player.Position.x -= velocity;
+            for (unsigned int i = 0; i < Balls.Count(); ++i)
+            {
+                if (Balls.IsStuck(i))
+                    Balls.X[i] -= velocity;
+            }
+        }
+    }
+    else if (direction > 0.0f)
+    {
+        if (this->Player.Position.x <= this->Width - this->Player.Size.x)
+        {
+            this->Player.Position.x += velocity;
+            for (unsigned int i = 0; i < Balls.Count(); ++i)
+            {
+                if (Balls.IsStuck(i))
+                    Balls.X[i] += velocity;
+            }
+        }
+    }
+}
+
+void Simulation::LaunchBall()
+{
+    for (unsigned int i = 0; i < Balls.Count(); ++i)
+    {
+        if (Balls.IsStuck(i))
+        {
+            Balls.Flags[i] &= ~BALL_STUCK;
+            Balls.VelocityX[i] = INITIAL_BALL_VELOCITY.x;
+            Balls.VelocityY[i] = INITIAL_BALL_VELOCITY.y;
+            break;
+        }
+    }
+}
+
+void Simulation::StartBallStorm(unsigned int count)
+{
+    // spread the balls over the width of the screen just above the paddle, all heading up at the
+    // speed of a launched ball; the golden ratio sequence fans their directions out evenly
+    float speed = glm::length(INITIAL_BALL_VELOCITY);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        glm::vec2 position((i + 0.5f) / count * (this->Width - 2.0f * BALL_RADIUS), this->Player.Position.y - 3.0f * BALL_RADIUS);
+        float angle = glm::radians(120.0f * (std::fmod(i * 0.618034f, 1.0f) - 0.5f));
+        this->Balls.Add(position, BALL_RADIUS, glm::vec2(std::sin(angle), -std::cos(angle)) * speed, 0);
+    }
+}
+
+void Simulation::BeginStep()
+{
+    this->Player.PreviousPosition = this->Player.Position;
+    Balls.PreviousX = Balls.X;
+    Balls.PreviousY = Balls.Y;
+    std::copy(this->PowerUps.X.begin(), this->PowerUps.X.begin() + this->PowerUps.Count(), this->PowerUps.PreviousX.begin());
+    std::copy(this->PowerUps.Y.begin(), this->PowerUps.Y.begin() + this->PowerUps.Count(), this->PowerUps.PreviousY.begin());
+}
+
+void Simulation::parallelFor(unsigned int count, unsigned int grain, const JobSystem::RangeTask& body)
+{
+    if (this->Jobs)
+        this->Jobs->Wait(this->Jobs->ParallelFor(0, count, grain, body));
+    else if (count > 0)
+        body(0, count);
+}
+
+void Simulation::emit(SimulationEventType type, glm::vec2 position)
+{
+    SimulationEvent event;
+    event.Type = type;
+    event.Position = position;
+    this->Events.push_back(event);
+}
+
+void Simulation::Update(float dt)
+{
+    this->Events.clear();
+    //starts the couuntdown
+    if (this->State == GAME_ACTIVE&&this->Countdown >0.0f) {
+        this->Countdown -= dt;
+    }
+
+    // balls out in the open (between the bricks and the paddle) are moved all together,
+    // the rest sweep through the level one at a time
+    float openTop = this->Current.Bottom(), openBottom = this->Player.Position.y;
+    unsigned int chunks = (this->Balls.Count() + BALLS_PER_JOB - 1) / BALLS_PER_JOB;
+    if (this->Scratch.size() < chunks)
+        this->Scratch.resize(chunks);
+    this->parallelFor(this->Balls.Count(), BALLS_PER_JOB, [this, dt, openTop, openBottom](unsigned int first, unsigned int last) {
+        std::vector<unsigned int>& rest = this->Scratch[first / BALLS_PER_JOB].Queue;
+        rest.clear();
+        MoveBalls(this->Balls, first, last, dt, this->Width, openTop, openBottom, rest);
+    });
+    this->BallQueue.clear();
+    for (unsigned int chunk = 0; chunk < chunks; ++chunk)
+        this->BallQueue.insert(this->BallQueue.end(), this->Scratch[chunk].Queue.begin(), this->Scratch[chunk].Queue.end());
+    // those sweep in parallel against the bricks as they were at the start of the step; what they hit is
+    // applied afterwards, in ball order, so the outcome doesn't depend on how the work was spread out
+    this->Claims.Reserve(this->Current.Bricks.Count());
+    unsigned int jobs = (static_cast<unsigned int>(this->BallQueue.size()) + SWEEPS_PER_JOB - 1) / SWEEPS_PER_JOB;
+    if (this->Scratch.size() < jobs)
+        this->Scratch.resize(jobs);
+    this->parallelFor(static_cast<unsigned int>(this->BallQueue.size()), SWEEPS_PER_JOB, [this, dt](unsigned int first, unsigned int last) {
+        CollisionScratch& scratch = this->Scratch[first / SWEEPS_PER_JOB];
+        scratch.Hits.clear();
+        for (unsigned int q = first; q < last; ++q)
+        {
+            unsigned int i = this->BallQueue[q];
+            BallObject ball = this->Balls.Get(i);
+            scratch.Ignored.clear();
+            this->MoveBall(ball, i, dt, scratch);
+            this->Balls.Set(i, ball);
+        }
+    });
+    this->applyHits(jobs);
+    // delete the balls out of the limits (the last ball takes the place of a deleted one, so walk backwards)
+    for (unsigned int i = this->Balls.Count(); i-- > 0;)
+    {
+        if (!this->Balls.IsStuck(i) && this->Balls.Y[i] >= this->Height)
+            this->Balls.Remove(i);
+    }
+    if (Balls.Count() == 1) {
+        Balls.Color[0] = glm::vec3(1.0f, 1.0f, 1.0f);
+    }
+
+    // check for collisions
+    this->DoCollisions();
+    // update PowerUps
+    this->UpdatePowerUps(dt);
+    // check loss condition
+    if (Balls.Empty() || this->Countdown < 0.0f) // did ball reach bottom edge? did the time ends?
+    {
+        --this->Lives;
+        // did the player lose all his lives? : Game over or the countdown end?
+        if (this->Lives == 0 || this->Countdown<0.0f)
+        {
+            this->ResetLevel();
+            this->State = GAME_MENU;
+        }
+        this->ResetPlayer();
+    }
+    // check win condition
+    if (this->State == GAME_ACTIVE && this->Current.IsCompleted())
+    {
+        this->ResetLevel();
+        this->ResetPlayer();
+        this->Chaos = true;
+        this->State = GAME_WIN;
+    }
+    // let audio/rendering react to what happened during this step
+    for (const SimulationEvent& event : this->Events)
+        for (SimulationListener* listener : this->listeners)
+            listener->OnSimulationEvent(event);
+}
+
+void Simulation::ResetLevel()
+{
+    if (this->pristine)
+        this->Current.Reset(*this->pristine);
+
+    this->Lives = 3;
+    this->Countdown = COUNTDOWN_START;
+}
+
+void Simulation::ResetPlayer()
+{
+    
+    // reset player/ball stats
+    this->Player.Size = PLAYER_SIZE;
+    this->Player.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f, this->Height - PLAYER_SIZE.y);
+    this->Player.PreviousPosition = this->Player.Position;
+    //then create a ball
+    glm::vec2 ballPos = this->Player.Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+    unsigned int ball = Balls.Add(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY, BALL_STUCK);
+    //Ball->Reset(this->Player.Position + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -(BALL_RADIUS * 2.0f)), INITIAL_BALL_VELOCITY);  //not necessary now because the vector Balls
+    // also disable all active powerups
+    this->Confuse = false;
+    this->Chaos = false;
+    this->Player.Color = glm::vec3(1.0f);
+    Balls.Color[ball] = glm::vec3(1.0f);
+    
+    this->ExtraLifeCounter = BLOCK_COUNT_LIFES;
+}
+void Simulation::UpdatePowerUps(float dt)
+{
+    // move the falling power-ups, in parallel (they all fall at the same speed)
+    this->parallelFor(this->PowerUps.Count(), POWERUPS_PER_JOB, [this, dt](unsigned int first, unsigned int last) {
+        for (unsigned int i = first; i < last; ++i)
+        {
+            this->PowerUps.X[i] += VELOCITY.x * dt;
+            this->PowerUps.Y[i] += VELOCITY.y * dt;
+        }
+    });
+    // run down the timers; an effect is only undone once the last pickup of its kind has run out
+    this->ExpiredEffects.clear();
+    this->Timers.Advance(dt, this->ExpiredEffects);
+    for (unsigned int effect : this->ExpiredEffects)
+        if (effect < POWERUP_TYPE_COUNT && POWERUP_TYPES[effect].Deactivate)
+            POWERUP_TYPES[effect].Deactivate(*this);
+}
+
+void Simulation::SpawnPowerUps(GameLevel& level, unsigned int brick)
+{
+    if (!(level.Bricks.Flags[brick] & BRICK_SPAWNED_POWERUP))  //to avoid two power ups from the same block
+    {
+        unsigned int drop = this->PowerUpDrops.Sample(this->Dice);
+        if (drop < POWERUP_TYPE_COUNT)
+            this->PowerUps.Spawn(static_cast<PowerUpType>(drop), level.Bricks.Position(brick));
+        level.Bricks.Flags[brick] |= BRICK_SPAWNED_POWERUP;
+    }
+}
+
+void Simulation::ActivatePowerUp(PowerUpType type)
+{
+    const PowerUpInfo& info = POWERUP_TYPES[type];
+    info.Activate(*this);
+    this->Timers.Start(type, info.Duration);
+}
+
+
+void Simulation::MoveBall(BallObject& ball, unsigned int id, float dt, CollisionScratch& scratch)
+{
+    const GameLevel& level = this->Current;
+    // the step is split at every impact along the ball's path, so no matter how fast the ball
+    // moves (or how long the frame was) it bounces off whatever it reaches first
+    float remaining = dt;
+    for (unsigned int bounce = 0; bounce < MAX_BALL_BOUNCES && remaining > 0.0f; ++bounce)
+    {
+        glm::vec2 center = ball.Position + ball.Radius;
+        glm::vec2 delta = ball.Velocity * remaining;
+        // broadphase on the swept bounding box of the remaining move
+        glm::vec2 reach(ball.Radius);
+        glm::vec2 sweepMin = glm::min(center, center + delta) - reach, sweepMax = glm::max(center, center + delta) + reach;
+        level.QueryBricks(sweepMin, sweepMax, scratch.Candidates);
+        bool nearPaddle = sweepMax.x >= this->Player.Position.x && sweepMin.x <= this->Player.Position.x + this->Player.Size.x &&
+            sweepMax.y >= this->Player.Position.y && sweepMin.y <= this->Player.Position.y + this->Player.Size.y;
+        bool nearBricks = false;
+        for (unsigned int candidate : scratch.Candidates)
+            nearBricks = nearBricks || this->isLive(level, candidate, scratch);
+        if (!nearBricks && !nearPaddle)
+        {    // nothing but the walls in the way
+            ball.Move(remaining, this->Width);
+            return;
+        }
+
+        // find the earliest impact: walls, bricks or the paddle
+        enum { HIT_NONE, HIT_WALL_X, HIT_WALL_Y, HIT_BRICK, HIT_PADDLE } hitKind = HIT_NONE;
+        float toi = 1.0f, t;
+        glm::vec2 normal, hitNormal;
+        unsigned int hitBrick = 0;
+        if (delta.x < 0.0f && ball.Position.x + delta.x <= 0.0f)
+        {
+            toi = std::max(-ball.Position.x / delta.x, 0.0f);
+            hitKind = HIT_WALL_X;
+        }
+        else if (delta.x > 0.0f && ball.Position.x + ball.Size.x + delta.x >= this->Width)
+        {
+            toi = std::max((this->Width - ball.Size.x - ball.Position.x) / delta.x, 0.0f);
+            hitKind = HIT_WALL_X;
+        }
+        if (delta.y < 0.0f && ball.Position.y + delta.y <= 0.0f && std::max(-ball.Position.y / delta.y, 0.0f) < toi)
+        {
+            toi = std::max(-ball.Position.y / delta.y, 0.0f);
+            hitKind = HIT_WALL_Y;
+        }
+        for (unsigned int candidate : scratch.Candidates)
+        {
+            if (this->isLive(level, candidate, scratch) && SweepCircleAABB(center, ball.Radius, delta, level.Bricks.Position(candidate), level.Bricks.Size(candidate), t, normal) && t < toi)
+            {
+                toi = t;
+                hitNormal = normal;
+                hitBrick = candidate;
+                hitKind = HIT_BRICK;
+            }
+        }
+        if (nearPaddle && SweepCircleAABB(center, ball.Radius, delta, this->Player.Position, this->Player.Size, t, normal) && t < toi)
+        {
+            toi = t;
+            hitKind = HIT_PADDLE;
+        }
+
+        // advance up to the impact, stopping a hair short of bricks and the paddle so the
+        // discrete pass in DoCollisions doesn't see the contact a second time
+        float advance = toi;
+        if (hitKind == HIT_BRICK || hitKind == HIT_PADDLE)
+            advance = std::max(toi - BALL_SKIN / glm::length(delta), 0.0f);
+        ball.Position += delta * advance;
+        remaining -= remaining * toi;
+        if (hitKind == HIT_NONE)
+            return;
+        if (hitKind == HIT_WALL_X)
+        {
+            ball.Velocity.x = -ball.Velocity.x;
+            ball.Position.x = ball.Velocity.x > 0.0f ? 0.0f : this->Width - ball.Size.x;
+        }
+        else if (hitKind == HIT_WALL_Y)
+        {
+            ball.Velocity.y = -ball.Velocity.y;
+            ball.Position.y = 0.0f;
+        }
+        else if (hitKind == HIT_BRICK)
+        {
+            if (this->hitBrick(ball, id, level, hitBrick, scratch))
+            {    // bounce along the dominant axis of the contact normal, like the discrete resolution does; on a
+                // corner that would still head into the brick, so bounce along the other axis (or both) instead
+                glm::vec2 flip = std::abs(hitNormal.x) > std::abs(hitNormal.y) ? glm::vec2(-1.0f, 1.0f) : glm::vec2(1.0f, -1.0f);
+                if (glm::dot(ball.Velocity * flip, hitNormal) < 0.0f)
+                    flip = glm::vec2(flip.y, flip.x);
+                if (glm::dot(ball.Velocity * flip, hitNormal) < 0.0f)
+                    flip = glm::vec2(-1.0f, -1.0f);
+                ball.Velocity *= flip;
+            }
+        }
+        else
+        {
+            this->hitPaddle(ball, id, scratch);
+            if (ball.Stuck)
+                return;
+        }
+    }
+}
+
+void Simulation::DoCollisions()
+{
+    GameLevel& level = this->Current;
+    for (unsigned int i = 0; i < this->PowerUps.Count();)
+    {
+        glm::vec2 position = this->PowerUps.Position(i);
+        if (CheckCollision(this->Player.Position, this->Player.Size, position, POWERUP_SIZE))
+        {    // collided with player, now activate powerup
+            ActivatePowerUp(this->PowerUps.Type[i]);
+            this->emit(EVENT_POWERUP_COLLECTED, position);
+            this->PowerUps.Remove(i); // the last one takes its place, so check index i again
+        }
+        else if (position.y >= this->Height)
+            this->PowerUps.Remove(i);
+        else
+            ++i;
+    }
+
+    // every ball resolves its contacts in parallel, against the bricks as they are now
+    this->Claims.Reserve(level.Bricks.Count());
+    unsigned int jobs = (this->Balls.Count() + BALLS_PER_JOB - 1) / BALLS_PER_JOB;
+    if (this->Scratch.size() < jobs)
+        this->Scratch.resize(jobs);
+    this->parallelFor(this->Balls.Count(), BALLS_PER_JOB, [this](unsigned int first, unsigned int last) {
+        CollisionScratch& scratch = this->Scratch[first / BALLS_PER_JOB];
+        scratch.Hits.clear();
+        for (unsigned int i = first; i < last; ++i)
+            this->collideBall(i, scratch);
+    });
+    this->applyHits(jobs);
+}
+
+void Simulation::collideBall(unsigned int i, CollisionScratch& scratch)
+{
+    const GameLevel& level = this->Current;
+    // a ball out in the open (with room for a radius on either side) can't touch any brick or the paddle
+    float radius = this->Balls.Radius[i];
+    if (this->Balls.Y[i] - radius > level.Bottom() && this->Balls.Y[i] + 3.0f * radius < this->Player.Position.y)
+        return;
+    BallObject ball = this->Balls.Get(i);
+    scratch.Ignored.clear();
+    // broadphase: only bricks on the lattice cells around the ball can be hit (the box is grown
+    // by the radius since resolving one hit can shift the ball by at most that much)
+    glm::vec2 reach(ball.Radius);
+    level.QueryBricks(ball.Position - reach, ball.Position + ball.Size + reach, scratch.Candidates);
+    // gather the live candidates so the narrow phase can test them all at once
+    scratch.Batch.Clear();
+    for (unsigned int candidate : scratch.Candidates)
+        if (this->isLive(level, candidate, scratch))
+            scratch.Batch.Add(candidate, level.Bricks.X[candidate], level.Bricks.Y[candidate], level.Bricks.Width[candidate], level.Bricks.Height[candidate]);
+    // hits are resolved in brick order; once a hit relocates the ball, the bricks after it are tested again from the new position
+    unsigned int next = 0;
+    while (next < scratch.Batch.Count())
+    {
+        unsigned int hits = CheckCollisionBatch(ball.Position + ball.Radius, ball.Radius, scratch.Batch, next);
+        next = scratch.Batch.Count();
+        for (unsigned int h = 0; h < hits; ++h)
+        {
+            const CollisionHit& hit = scratch.Batch.Hits[h];
+            // collision resolution
+            Direction dir = hit.Dir;
+            glm::vec2 diff_vector = hit.Difference;
+            if (this->hitBrick(ball, i, level, scratch.Batch.Source[hit.Index], scratch))
+            {
+                if (dir == LEFT || dir == RIGHT) // horizontal collision
+                {
+                    ball.Velocity.x = -ball.Velocity.x; // reverse horizontal velocity
+                    // relocate
+                    float penetration = ball.Radius - std::abs(diff_vector.x);
+                    if (dir == LEFT)
+                        ball.Position.x += penetration; // move ball to right
+                    else
+                        ball.Position.x -= penetration; // move ball to left;
+                }
+                else // vertical collision
+                {
+                    ball.Velocity.y = -ball.Velocity.y; // reverse vertical velocity
+                    // relocate
+                    float penetration = ball.Radius - std::abs(diff_vector.y);
+                    if (dir == UP)
+                        ball.Position.y -= penetration; // move ball back up
+                    else
+                        ball.Position.y += penetration; // move ball back down
+                }
+                next = hit.Index + 1;
+                break;
+            }
+        }
+    }
+
+    // check collisions for player pad (unless stuck)
+    Collision result = CheckCollision(ball, this->Player);
+    if (!ball.Stuck && std::get<0>(result))
+        this->hitPaddle(ball, i, scratch);
+    this->Balls.Set(i, ball);
+}
+
+bool Simulation::isLive(const GameLevel& level, unsigned int brick, const CollisionScratch& scratch) const
+{
+    return !level.Bricks.IsDestroyed(brick) && std::find(scratch.Ignored.begin(), scratch.Ignored.end(), brick) == scratch.Ignored.end();
+}
+
+bool Simulation::hitBrick(BallObject& ball, unsigned int id, const GameLevel& level, unsigned int brick, CollisionScratch& scratch)
+{
+    bool solid = level.Bricks.IsSolid(brick);
+    BallHit hit;
+    hit.Ball = id;
+    hit.Brick = static_cast<int>(brick);
+    hit.Position = ball.Position;
+    scratch.Hits.push_back(hit);
+    if (!solid)
+    {   // the brick breaks: claim it, and don't let this ball hit it again
+        this->Claims.Claim(brick, id);
+        scratch.Ignored.push_back(brick);
+    }
+    // pass-through balls only bounce off solid blocks
+    return !(ball.PassThrough && !solid);
+}
+
+void Simulation::hitPaddle(BallObject& ball, unsigned int id, CollisionScratch& scratch)
+{
+    // check where it hit the board, and change velocity based on where it hit the board
+    float centerBoard = this->Player.Position.x + this->Player.Size.x / 2.0f;
+    float distance = (ball.Position.x + ball.Radius) - centerBoard;
+    float percentage = distance / (this->Player.Size.x / 2.0f);
+    // then move accordingly
+    float strength = 2.0f;
+    glm::vec2 oldVelocity = ball.Velocity;
+    ball.Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+    //Ball->Velocity.y = -Ball->Velocity.y;
+    ball.Velocity = glm::normalize(ball.Velocity) * glm::length(oldVelocity); // keep speed consistent over both axes (multiply by length of old velocity, so total strength is not changed)
+    // fix sticky paddle
+    ball.Velocity.y = -1.0f * std::abs(ball.Velocity.y);
+    ball.Stuck = ball.Sticky;
+
+    BallHit hit;
+    hit.Ball = id;
+    hit.Brick = -1;
+    hit.Position = ball.Position;
+    scratch.Hits.push_back(hit);
+}
+
+
+void Simulation::applyHits(unsigned int jobs)
+{
+    GameLevel& level = this->Current;
+    // the jobs cover the balls in order, so this walks the hits in ball order whatever thread found them
+    for (unsigned int job = 0; job < jobs; ++job)
+    {
+        for (const BallHit& hit : this->Scratch[job].Hits)
+        {
+            if (hit.Brick < 0)
+            {
+                this->emit(EVENT_PADDLE_HIT, hit.Position);
+                continue;
+            }
+            unsigned int brick = static_cast<unsigned int>(hit.Brick);
+            if (level.Bricks.IsSolid(brick))
+            {   // if block is solid, enable shake effect
+                this->Timers.Start(EFFECT_SHAKE, SHAKE_DURATION);
+                this->ExtraLifeCounter = BLOCK_COUNT_LIFES;
+                this->emit(EVENT_SOLID_HIT, level.Bricks.Position(brick));
+            }
+            else if (this->Claims.Owner(brick) == hit.Ball)
+            {   // destroy block if not solid; only the ball that claimed it does (the others just bounce off)
+                this->Claims.Release(brick);
+                level.DestroyBrick(brick);
+                this->ExtraLifeCounter--;
+                this->SpawnPowerUps(level, brick);
+                this->emit(EVENT_BRICK_DESTROYED, level.Bricks.Position(brick));
+                if (ExtraLifeCounter <1) {
+                    this->Lives++;
+                    ExtraLifeCounter = BLOCK_COUNT_LIFES;
+                }
+            }
+        }
+    }
+}
+
+void BrickClaims::Reserve(unsigned int count)
+{
+    if (count <= this->capacity)
+        return;
+    this->owners.reset(new std::atomic<unsigned int>[count]);
+    for (unsigned int i = 0; i < count; ++i)
+        this->owners[i].store(NONE, std::memory_order_relaxed);
+    this->capacity = count;
+}
+
+void BrickClaims::Claim(unsigned int brick, unsigned int ball)
+{
+    // atomic minimum: retry until our id is in or a lower one got there first
+    std::atomic<unsigned int>& owner = this->owners[brick];
+    unsigned int current = owner.load(std::memory_order_relaxed);
+    while (ball < current && !owner.compare_exchange_weak(current, ball, std::memory_order_relaxed))
+        ;
+}
+
+static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t size)
+{
+    // FNV-1a
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+template <typename T>
+static unsigned long long hashVector(unsigned long long hash, const std::vector<T>& data)
+{
+    return data.empty() ? hash : hashBytes(hash, &data[0], data.size() * sizeof(T));
+}
+
+unsigned long long Simulation::Checksum() const
+{
+    unsigned long long hash = 14695981039346656037ull;
+    hash = hashVector(hash, this->Balls.X);
+    hash = hashVector(hash, this->Balls.Y);
+    hash = hashVector(hash, this->Balls.VelocityX);
+    hash = hashVector(hash, this->Balls.VelocityY);
+    hash = hashVector(hash, this->Balls.Flags);
+    if (this->pristine)
+        hash = hashVector(hash, this->Current.Bricks.Flags);
+    unsigned int pickups = this->PowerUps.Count();
+    hash = hashBytes(hash, &pickups, sizeof(pickups));
+    hash = hashBytes(hash, &this->PowerUps.X[0], pickups * sizeof(float));
+    hash = hashBytes(hash, &this->PowerUps.Y[0], pickups * sizeof(float));
+    hash = hashBytes(hash, &this->PowerUps.Type[0], pickups * sizeof(PowerUpType));
+    hash = hashBytes(hash, &this->Player.Position, sizeof(this->Player.Position));
+    hash = hashBytes(hash, &this->Player.Size, sizeof(this->Player.Size));
+    unsigned int counters[] = { static_cast<unsigned int>(this->State), this->Level, this->Lives, this->ExtraLifeCounter };
+    hash = hashBytes(hash, counters, sizeof(counters));
+    hash = hashBytes(hash, &this->Countdown, sizeof(this->Countdown));
+    for (unsigned int effect = 0; effect < EFFECT_COUNT; ++effect)
+    {
+        unsigned int references = this->Timers.References(effect);
+        hash = hashBytes(hash, &references, sizeof(references));
+    }
+    return hash;
+}
\ No newline at end of file
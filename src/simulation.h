@@ -0,0 +1,212 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "game_level.h"
+#include "game_object.h"
+#include "power_up.h"
+#include "ballObject.h"
+#include "collision.h"
+#include "effect_scheduler.h"
+#include "job_system.h"
+#include "level_catalog.h"
+#include "random.h"
+
+// Represents the current state of the game
+enum GameState {
+    GAME_ACTIVE,
+    GAME_MENU,
+    GAME_WIN
+};
+
+// Initial size of the player paddle
+const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
+// Initial velocity of the player paddle
+const float PLAYER_VELOCITY(500.0f);
+// Initial velocity of the Ball
+const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
+// Radius of the ball object
+const float BALL_RADIUS = 12.5f;
+// Maximum number of impacts resolved for a single ball per update
+const unsigned int MAX_BALL_BOUNCES = 16;
+// Distance a swept ball is kept away from what it hit
+const float BALL_SKIN = 0.01f;
+
+//the numbers of blocks destroyed for extra life
+const int BLOCK_COUNT_LIFES = 10;
+
+//the start countdown
+const float COUNTDOWN_START = 180;
+// How long the screen shakes after a solid block is hit
+const float SHAKE_DURATION = 0.05f;
+// Number of balls released at once in ball storm mode
+const unsigned int BALL_STORM_SIZE = 10000;
+// Number of balls/power-ups handed to one job when a step's work is spread over threads
+const unsigned int BALLS_PER_JOB = 1024;
+const unsigned int POWERUPS_PER_JOB = 256;
+// Number of balls swept through the level by one job (those are the expensive ones)
+const unsigned int SWEEPS_PER_JOB = 64;
+// Fixed duration of one simulation step (120 Hz), independent of the render rate
+const float SIMULATION_STEP = 1.0f / 120.0f;
+
+// The timed effects in Simulation::Timers: one per PowerUpType (numbered the same), followed by these
+enum TimedEffect {
+    EFFECT_SHAKE = POWERUP_TYPE_COUNT,
+    EFFECT_COUNT
+};
+
+// Things that happen during a simulation step that audio and rendering react to
+enum SimulationEventType {
+    EVENT_BRICK_DESTROYED,
+    EVENT_SOLID_HIT,
+    EVENT_PADDLE_HIT,
+    EVENT_POWERUP_COLLECTED,
+    EVENT_TYPE_COUNT
+};
+
+struct SimulationEvent {
+    SimulationEventType Type;
+    glm::vec2           Position; // where it happened
+};
+
+// Implemented by everything that wants to hear about simulation events (audio, screen effects, stats)
+class SimulationListener
+{
+public:
+    virtual ~SimulationListener() { }
+    virtual void OnSimulationEvent(const SimulationEvent& event) = 0;
+};
+
+// A brick or paddle contact found while balls are resolved in parallel; the side effects
+// (destroying the brick, scoring, events) are applied afterwards, in ball order
+struct BallHit {
+    unsigned int Ball;
+    int          Brick;    // -1 for the paddle
+    glm::vec2    Position; // ball position at the time of the hit
+};
+
+// Per-job working space for resolving ball collisions
+struct CollisionScratch {
+    std::vector<unsigned int> Candidates; // bricks near the ball
+    CollisionBatch            Batch;
+    std::vector<unsigned int> Ignored;    // bricks the current ball already broke this phase
+    std::vector<unsigned int> Queue;      // balls that need the full sweep (found by MoveBalls)
+    std::vector<BallHit>      Hits;
+};
+
+// BrickClaims settles which ball breaks a brick when several hit it in the same phase:
+// every ball claims it and the lowest ball id wins, whichever thread gets there first
+class BrickClaims
+{
+public:
+    static const unsigned int NONE = 0xFFFFFFFF;
+    BrickClaims() : capacity(0) { }
+    // makes room for count bricks (never shrinks; claims are released as they are applied)
+    void Reserve(unsigned int count);
+    void Claim(unsigned int brick, unsigned int ball);
+    unsigned int Owner(unsigned int brick) const { return this->owners[brick].load(std::memory_order_relaxed); }
+    void Release(unsigned int brick) { this->owners[brick].store(NONE, std::memory_order_relaxed); }
+private:
+    std::unique_ptr<std::atomic<unsigned int>[]> owners;
+    unsigned int capacity;
+};
+
+// Simulation holds all gameplay state (levels, paddle, balls, power-ups, timers) and
+// advances it in fixed steps. It doesn't depend on OpenGL, GLFW or irrKlang, so it can
+// run without a window, GL context or audio device; the presentation side reads its
+// state and subscribes to its events.
+class Simulation
+{
+public:
+    // game state
+    GameState               State;
+
+    //extra Power up
+    bool                    Split;
+
+    float                   Countdown;
+    unsigned int            Width, Height;
+    LevelCatalog            Catalog; // the levels there are
+    GameLevel               Current; // the level selected/being played
+    PickupPool              PowerUps; // falling power-ups
+    BallStore               Balls; // To manage the balls
+    GameObject              Player;
+    unsigned int            Level;
+    unsigned int            Lives;
+    unsigned int            ExtraLifeCounter;
+    // screen effects requested by gameplay (applied by the renderer)
+    bool                    Confuse, Chaos;
+    // timers of the active power-ups and screen shake (indexed by TimedEffect)
+    EffectScheduler         Timers;
+    // events raised during the last step, in the order they happened
+    std::vector<SimulationEvent> Events;
+    // runs the parallel parts of a step (if not set, everything runs on the calling thread)
+    JobSystem*              Jobs;
+    // the gameplay random stream (power-up drops); the same seed plays out the same game
+    Random                  Dice;
+    // constructor
+    Simulation(unsigned int width, unsigned int height);
+    // finds the levels in directory, selects the first one and puts the player and ball at their start position
+    void LoadLevels(const std::string& directory);
+    // registers a listener that is handed every event at the end of each step
+    void Subscribe(SimulationListener* listener);
+    // restarts the gameplay random stream
+    void Seed(std::uint64_t seed);
+    // input
+    void Start();                                  // menu -> playing
+    void SelectLevel(int step);                    // cycles through the levels in the menu
+    void ReturnToMenu();                           // win screen -> menu
+    void MovePaddle(float direction, float dt);    // direction < 0 moves left, > 0 moves right
+    void LaunchBall();
+    void StartBallStorm(unsigned int count);       // releases count extra balls at once (ball storm mode)
+    // BeginStep remembers where everything was, then Update advances the game by one fixed step
+    void BeginStep();
+    void Update(float dt);
+    void DoCollisions();
+    // moves a ball (with index id) through the level, resolving every impact along its path (continuous
+    // collision detection); what it hits is recorded in scratch.Hits instead of being applied
+    void MoveBall(BallObject& ball, unsigned int id, float dt, CollisionScratch& scratch);
+    // reset
+    void ResetLevel();
+    void ResetPlayer();
+
+    void SpawnPowerUps(GameLevel& level, unsigned int brick);
+    void UpdatePowerUps(float dt);
+    void ActivatePowerUp(PowerUpType type);
+    // hash of the gameplay state, to check that runs (e.g. with different thread counts) stay identical
+    unsigned long long Checksum() const;
+private:
+    std::vector<SimulationListener*> listeners;
+    // Current as loaded, which ResetLevel restores it from (never played on)
+    std::shared_ptr<const GameLevel> pristine;
+    // makes Level the current level and has its neighbours loaded ahead
+    void useLevel();
+    // collision responses shared by the swept and the discrete collision checks; they only change the
+    // ball and record the hit. hitBrick returns whether the ball bounces off the brick
+    bool hitBrick(BallObject& ball, unsigned int id, const GameLevel& level, unsigned int brick, CollisionScratch& scratch);
+    void hitPaddle(BallObject& ball, unsigned int id, CollisionScratch& scratch);
+    // whether a brick is still there for the ball being resolved
+    bool isLive(const GameLevel& level, unsigned int brick, const CollisionScratch& scratch) const;
+    // resolves the contacts of a ball at rest against the bricks and the paddle
+    void collideBall(unsigned int i, CollisionScratch& scratch);
+    // applies the hits recorded by the first `jobs` jobs, in order
+    void applyHits(unsigned int jobs);
+    // runs body over [0, count) in chunks of grain items, on the job system if there is one
+    void parallelFor(unsigned int count, unsigned int grain, const JobSystem::RangeTask& body);
+    // records an event for the listeners
+    void emit(SimulationEventType type, glm::vec2 position);
+    // balls that need the full swept collision this step, reused every step by Update
+    std::vector<unsigned int> BallQueue;
+    std::vector<CollisionScratch> Scratch; // one per job, reused every step
+    BrickClaims               Claims;
+    std::vector<unsigned int> ExpiredEffects; // reused every step by UpdatePowerUps
+    // what a destroyed brick drops: one outcome per PowerUpType, then POWERUP_TYPE_COUNT for nothing
+    AliasTable                PowerUpDrops;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "software_mixer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "wav_file.h"
+
+// pick the widest vector unit the compiler targets; everything else falls back to the scalar path
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MIXER_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIXER_LANES 4
+#endif
+
+
+// adds count interleaved stereo samples to out, scaled by the gain of their side
+static void mixInto(float* out, const float* in, unsigned int count, float gainLeft, float gainRight)
+{
+    unsigned int i = 0;
+#if MIXER_LANES == 8
+    __m256 gain = _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight);
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(in + i), gain)));
+#elif MIXER_LANES == 4
+    __m128 gain = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), gain)));
+#endif
+    for (; i < count; i += 2)
+    {
+        out[i] += in[i] * gainLeft;
+        out[i + 1] += in[i + 1] * gainRight;
+    }
+}
+
+// one float sample to 16 bits, clipped to the range
+static short toPcm16(float sample)
+{
+    float scaled = std::min(std::max(sample * 32767.0f, -32768.0f), 32767.0f);
+    return static_cast<short>(std::nearbyint(scaled));
+}
+
+// converts count float samples to 16 bits
+static void convert(short* out, const float* in, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MIXER_LANES
+    // SSE2 is enough here: the conversion rounds to nearest like nearbyint, and the pack saturates
+    __m128 scale = _mm_set1_ps(32767.0f), low = _mm_set1_ps(-32768.0f), high = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i), scale), low), high);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale), low), high);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = toPcm16(in[i]);
+#ifndef NDEBUG
+    for (unsigned int j = 0; j < count; ++j)
+        assert(out[j] == toPcm16(in[j]));
+#endif
+}
+
+SoftwareMixer::SoftwareMixer(AudioSink* sink, unsigned int rate)
+    : sink(sink), rate(rate), pendingFrames(0.0), prefetchedSample(-1), mixBuffer(MIXER_BLOCK * 2), streamBuffer(MIXER_BLOCK * 2), output(MIXER_BLOCK * 2)
+{
+    for (Voice& voice : this->voices)
+    {
+        voice.Sample = -1;
+        voice.Generation = 0;
+    }
+}
+
+int SoftwareMixer::LoadSound(const char* file, bool stream)
+{
+    Sample sample;
+    if (stream)
+    {   // only check the header now; the track is decoded while it plays
+        WavReader reader;
+        if (!reader.Open(file))
+            return -1;
+        sample.File = file;
+    }
+    else if (!LoadWav(file, this->rate, sample.Frames))
+        return -1;
+    this->samples.push_back(std::move(sample));
+    return static_cast<int>(this->samples.size() - 1);
+}
+
+VoiceHandle SoftwareMixer::StartVoice(int sample, float volume, float pan, bool looped)
+{
+    if (sample < 0 || (this->samples[sample].Frames.empty() && this->samples[sample].File.empty()))
+        return 0;
+    for (unsigned int i = 0; i < MIXER_VOICES; ++i)
+    {
+        Voice& voice = this->voices[i];
+        if (voice.Sample >= 0)
+            continue;
+        if (!this->samples[sample].File.empty())
+        {
+            voice.Stream = this->openStream(sample, looped);
+            if (!voice.Stream)
+                return 0;
+        }
+        voice.Sample = sample;
+        voice.Position = 0;
+        // balance: the side panned away from gets quieter, the other keeps the full volume
+        voice.GainLeft = volume * std::min(1.0f - pan, 1.0f);
+        voice.GainRight = volume * std::min(1.0f + pan, 1.0f);
+        voice.Looped = looped;
+        ++voice.Generation;
+        return (voice.Generation << 8) | (i + 1);
+    }
+    return 0; // all voices busy
+}
+
+void SoftwareMixer::Prefetch(int sample)
+{
+    if (sample < 0 || this->samples[sample].File.empty() || this->prefetchedSample == sample)
+        return;
+    // music loops, so that's what is prefetched
+    this->prefetched = this->openStream(sample, true);
+    this->prefetchedSample = this->prefetched ? sample : -1;
+}
+
+std::unique_ptr<MusicStream> SoftwareMixer::openStream(int sample, bool looped)
+{
+    // a stream prefetched for this sample has its first chunks decoded already
+    if (this->prefetchedSample == sample && this->prefetched->Looped() == looped)
+    {
+        this->prefetchedSample = -1;
+        return std::move(this->prefetched);
+    }
+    std::unique_ptr<MusicStream> stream(new MusicStream());
+    if (!stream->Open(this->samples[sample].File.c_str(), this->rate, looped))
+        return nullptr;
+    return stream;
+}
+
+SoftwareMixer::Voice* SoftwareMixer::find(VoiceHandle handle)
+{
+    unsigned int slot = handle & 0xFF;
+    if (slot == 0 || slot > MIXER_VOICES)
+        return nullptr;
+    Voice& voice = this->voices[slot - 1];
+    return voice.Sample >= 0 && voice.Generation == (handle >> 8) ? &voice : nullptr;
+}
+
+bool SoftwareMixer::IsPlaying(VoiceHandle handle)
+{
+    return this->find(handle) != nullptr;
+}
+
+void SoftwareMixer::StopVoice(VoiceHandle handle)
+{
+    if (Voice* voice = this->find(handle))
+    {
+        voice->Sample = -1;
+        voice->Stream.reset();
+    }
+}
+
+void SoftwareMixer::Advance(float seconds)
+{
+    this->pendingFrames += static_cast<double>(seconds) * this->rate;
+    while (this->pendingFrames >= 1.0)
+    {
+        unsigned int frames = static_cast<unsigned int>(std::min(this->pendingFrames, static_cast<double>(MIXER_BLOCK)));
+        this->Mix(&this->output[0], frames);
+        if (this->sink)
+            this->sink->Write(&this->output[0], frames);
+        this->pendingFrames -= frames;
+    }
+}
+
+void SoftwareMixer::Mix(short* out, unsigned int frames)
+{
+    for (unsigned int done = 0; done < frames;)
+    {
+        unsigned int block = std::min(frames - done, MIXER_BLOCK);
+        float* mix = &this->mixBuffer[0];
+        std::memset(mix, 0, block * 2 * sizeof(float));
+        for (Voice& voice : this->voices)
+        {
+            if (voice.Stream)
+            {
+                this->mixStream(voice, mix, block);
+                continue;
+            }
+            // a voice plays until its sample runs out (or forever, if looped)
+            for (unsigned int mixed = 0; voice.Sample >= 0 && mixed < block;)
+            {
+                const std::vector<float>& sample = this->samples[voice.Sample].Frames;
+                unsigned int length = static_cast<unsigned int>(sample.size() / 2);
+                unsigned int count = std::min(block - mixed, length - voice.Position);
+                mixInto(mix + mixed * 2, &sample[voice.Position * 2], count * 2, voice.GainLeft, voice.GainRight);
+                mixed += count;
+                voice.Position += count;
+                if (voice.Position == length)
+                {
+                    if (voice.Looped)
+                        voice.Position = 0;
+                    else
+                        voice.Sample = -1;
+                }
+            }
+        }
+        convert(out + done * 2, mix, block * 2);
+        done += block;
+    }
+}
+
+void SoftwareMixer::mixStream(Voice& voice, float* mix, unsigned int frames)
+{
+    for (unsigned int mixed = 0; mixed < frames;)
+    {
+        unsigned int count = voice.Stream->Read(&this->streamBuffer[0], frames - mixed);
+        if (count == 0)
+        {
+            if (voice.Stream->Finished())
+            {
+                voice.Sample = -1;
+                voice.Stream.reset();
+                return;
+            }
+            // the decoder is behind; the output follows game time, not a device clock, so wait rather than drop out
+            std::this_thread::yield();
+            continue;
+        }
+        mixInto(mix + mixed * 2, &this->streamBuffer[0], count * 2, voice.GainLeft, voice.GainRight);
+        mixed += count;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef SOFTWARE_MIXER_H
+#define SOFTWARE_MIXER_H
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_backend.h"
+#include "music_stream.h"
+
+
+// Sample rate the software mixer runs at (unless given otherwise)
+const unsigned int MIXER_RATE = 44100;
+// Number of voices the software mixer plays at once
+const unsigned int MIXER_VOICES = 64;
+// Number of frames mixed in one go
+const unsigned int MIXER_BLOCK = 512;
+
+// SoftwareMixer is an AudioBackend that mixes the sounds itself (vectorized with
+// SSE2/AVX2 where available) and hands the result to an AudioSink, such as a .wav
+// file. It plays .wav files only; streamed sounds are decoded while they play by a
+// MusicStream. It produces sound as game time passes (Advance) rather than in real time,
+// so the same game always mixes to the same output (if a stream's decoder falls behind,
+// the mixer waits for it instead of leaving a gap).
+class SoftwareMixer : public AudioBackend
+{
+public:
+    // constructor; the sink has to outlive the mixer
+    SoftwareMixer(AudioSink* sink, unsigned int rate = MIXER_RATE);
+    int         LoadSound(const char* file, bool stream);
+    VoiceHandle StartVoice(int sample, float volume, float pan, bool looped);
+    void        Prefetch(int sample);
+    bool        IsPlaying(VoiceHandle voice);
+    void        StopVoice(VoiceHandle voice);
+    void        Advance(float seconds);
+    // mixes the next frames of all playing voices into out (interleaved 16-bit stereo)
+    void        Mix(short* out, unsigned int frames);
+private:
+    struct Sample {
+        std::vector<float> Frames; // interleaved stereo (empty if streamed)
+        std::string        File;   // streamed from this file while playing, if not empty
+    };
+    struct Voice {
+        int                          Sample;     // -1 when the voice is free
+        unsigned int                 Position;   // next frame to play
+        float                        GainLeft, GainRight;
+        bool                         Looped;
+        unsigned int                 Generation; // tells a voice's handles apart from those of earlier voices in the slot
+        std::unique_ptr<MusicStream> Stream;     // of a streamed sample
+    };
+    AudioSink*                   sink;
+    unsigned int                 rate;
+    double                       pendingFrames; // game time not mixed yet, in frames
+    std::vector<Sample>          samples;
+    Voice                        voices[MIXER_VOICES];
+    std::unique_ptr<MusicStream> prefetched;    // stream opened by Prefetch, until its voice starts
+    int                          prefetchedSample;
+    std::vector<float>           mixBuffer;
+    std::vector<float>           streamBuffer;
+    std::vector<short>           output;
+    // the voice a handle refers to, or nullptr if it has finished
+    Voice* find(VoiceHandle handle);
+    // opens a stream of a streamed sample, or nullptr if it can't be played
+    std::unique_ptr<MusicStream> openStream(int sample, bool looped);
+    // mixes the next frames of a streamed voice into mix
+    void   mixStream(Voice& voice, float* mix, unsigned int frames);
+};
+
+#endif
\ No newline at end of file
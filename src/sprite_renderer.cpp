@@ -1,7 +1,12 @@
 #include "sprite_renderer.h"
 
+#include <algorithm>
 
-SpriteRenderer::SpriteRenderer(Shader shader)
+// the shader reads an instance as three vec4s
+static_assert(sizeof(SpriteInstance) == 12 * sizeof(float), "SpriteInstance must be tightly packed");
+
+SpriteRenderer::SpriteRenderer(Shader shader, StreamBuffer* stream)
+    : stream(stream)
 {
     this->shader = shader;
     this->initRenderData();
@@ -10,38 +15,67 @@ SpriteRenderer::SpriteRenderer(Shader shader)
 SpriteRenderer::~SpriteRenderer()
 {
     glDeleteVertexArrays(1, &this->quadVAO);
+    glDeleteBuffers(1, &this->quadVBO);
 }
 
-void SpriteRenderer::DrawSprite(Texture2D texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color)
+void SpriteRenderer::DrawSprite(const Sprite& sprite, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color)
 {
-    // prepare transformations
-    this->shader.Use();
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(position, 0.0f));  // first translate (transformations are: scale happens first, then rotation, and then final translation happens; reversed order)
-
-    model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); // move origin of rotation to center of quad
-    model = glm::rotate(model, glm::radians(rotate), glm::vec3(0.0f, 0.0f, 1.0f)); // then rotate
-    model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); // move origin back
-
-    model = glm::scale(model, glm::vec3(size, 1.0f)); // last scale
+    // the shader rotates around the center of the quad, scales and translates it
+    SpriteInstance instance = { position, size, color, glm::radians(rotate), sprite.UV };
+    this->queued.push_back(instance);
+    this->textures.push_back(sprite.Texture);
+}
 
-    this->shader.SetMatrix4("model", model);
+void SpriteRenderer::DrawSprite(const Texture2D& texture, glm::vec2 position, glm::vec2 size, float rotate, glm::vec3 color)
+{
+    Sprite whole = { texture.ID, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f) };
+    this->DrawSprite(whole, position, size, rotate, color);
+}
 
-    // render textured quad
-    this->shader.SetVector3f("spriteColor", color);
+void SpriteRenderer::Flush()
+{
+    unsigned int count = static_cast<unsigned int>(this->queued.size());
+    if (count == 0)
+        return;
+    // group the sprites by texture; stable, so sprites of one texture keep their order
+    this->order.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+        this->order[i] = i;
+    const std::vector<unsigned int>& textures = this->textures;
+    std::stable_sort(this->order.begin(), this->order.end(), [&textures](unsigned int a, unsigned int b) { return textures[a] < textures[b]; });
+    // write the instances in that order straight into the stream buffer
+    SpriteInstance* instances = static_cast<SpriteInstance*>(this->stream->Map(count * sizeof(SpriteInstance)));
+    for (unsigned int i = 0; i < count; ++i)
+        instances[i] = this->queued[this->order[i]];
+    size_t offset = this->stream->Unmap();
 
+    // one draw per run of sprites with the same texture
+    this->shader.Use();
     glActiveTexture(GL_TEXTURE0);
-    texture.Bind();
-
     glBindVertexArray(this->quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    for (unsigned int first = 0; first < count;)
+    {
+        unsigned int texture = textures[this->order[first]];
+        unsigned int last = first + 1;
+        while (last < count && textures[this->order[last]] == texture)
+            ++last;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        // instanced attributes start at the run's first sprite
+        for (unsigned int attribute = 0; attribute < 3; ++attribute)
+            glVertexAttribPointer(1 + attribute, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(offset + first * sizeof(SpriteInstance) + attribute * 4 * sizeof(float)));
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, last - first);
+        first = last;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+
+    this->queued.clear();
+    this->textures.clear();
 }
 
 void SpriteRenderer::initRenderData()
 {
     // configure VAO/VBO
-    unsigned int VBO;
     float vertices[] = {
         // pos      // tex
         0.0f, 1.0f, 0.0f, 1.0f,
@@ -54,14 +88,20 @@ void SpriteRenderer::initRenderData()
     };
 
     glGenVertexArrays(1, &this->quadVAO);
-    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &this->quadVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glBindVertexArray(this->quadVAO);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    // per sprite: <position, size>, <color, rotation>, <uv offset, uv size> (pointed into the stream buffer by Flush)
+    for (unsigned int attribute = 1; attribute <= 3; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
\ No newline at end of file
@@ -1,26 +1,52 @@
 #ifndef SPRITE_RENDERER_H
 #define SPRITE_RENDERER_H
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
 #include "texture.h"
+#include "texture_atlas.h"
+#include "stream_buffer.h"
 #include "shader.h"
 
 
+// Per-instance data of a queued sprite, as the sprite shader reads it
+struct SpriteInstance {
+    glm::vec2 Position, Size;
+    glm::vec3 Color;
+    float     Rotation; // in radians
+    glm::vec4 UV;       // part of the texture to show: offset, size
+};
+
+// SpriteRenderer draws sprites in batches: DrawSprite only queues a sprite, and Flush
+// draws all sprites queued since the last Flush with one instanced draw call per
+// texture. Within a flush the sprites are sorted by texture (keeping their order
+// otherwise), so sprites that overlap and have to stay in order belong in separate
+// flushes.
 class SpriteRenderer
 {
 public:
-    // Constructor (inits shaders/shapes)
-    SpriteRenderer(Shader shader);
+    // Constructor (inits shaders/shapes); the instances of each flush are written to stream
+    SpriteRenderer(Shader shader, StreamBuffer* stream);
     // Destructor
     ~SpriteRenderer();
-    // Renders a defined quad textured with given sprite
-    void DrawSprite(Texture2D texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Queues a quad textured with given sprite (part of a texture, e.g. of an atlas); rotate is in degrees
+    void DrawSprite(const Sprite& sprite, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Queues a quad textured with the whole texture
+    void DrawSprite(const Texture2D& texture, glm::vec2 position, glm::vec2 size = glm::vec2(10.0f, 10.0f), float rotate = 0.0f, glm::vec3 color = glm::vec3(1.0f));
+    // Draws the queued sprites
+    void Flush();
 private:
     // Render state
-    Shader       shader;
-    unsigned int quadVAO;
+    Shader        shader;
+    StreamBuffer* stream;
+    unsigned int  quadVAO, quadVBO;
+    // Queued sprites and the texture of each
+    std::vector<SpriteInstance> queued;
+    std::vector<unsigned int>   textures;
+    // Flush scratch: the queued sprites in texture order
+    std::vector<unsigned int>   order;
     // Initializes and configures the quad's buffer and vertex attributes
     void initRenderData();
 };
@@ -0,0 +1,48 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+#include <atomic>
+#include <cstddef>
+
+
+// SpscRing is a fixed-size, lock-free queue for exactly one producer thread and one
+// consumer thread. Neither side ever blocks: TryPush fails when the ring is full and
+// TryPop fails when it is empty. Capacity must be a power of two.
+template <typename T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+public:
+    SpscRing() : head(0), tail(0) { }
+    // producer side; returns false (and drops item) if the ring is full
+    bool TryPush(const T& item)
+    {
+        std::size_t position = this->tail.load(std::memory_order_relaxed);
+        if (position - this->head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        this->items[position & (Capacity - 1)] = item;
+        this->tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    // consumer side; returns false if the ring is empty
+    bool TryPop(T& item)
+    {
+        std::size_t position = this->head.load(std::memory_order_relaxed);
+        if (position == this->tail.load(std::memory_order_acquire))
+            return false;
+        item = this->items[position & (Capacity - 1)];
+        this->head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    bool Empty() const { return this->head.load(std::memory_order_acquire) == this->tail.load(std::memory_order_acquire); }
+    // number of items waiting (exact for the producer, at most this many for the consumer)
+    std::size_t Size() const { return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire); }
+private:
+    // the two counters only ever grow; padding keeps them on separate cache lines so the threads don't fight over them
+    std::atomic<std::size_t> head; // next item to pop (written by the consumer)
+    char                     headPadding[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail; // next free slot (written by the producer)
+    char                     tailPadding[64 - sizeof(std::atomic<std::size_t>)];
+    T                        items[Capacity];
+};
+
+#endif
\ No newline at end of file
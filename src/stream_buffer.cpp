@@ -0,0 +1,143 @@
+#include "stream_buffer.h"
+
+#include <chrono>
+#include <iostream>
+
+StreamBuffer::StreamBuffer(size_t frameSize)
+    : ID(0), persistent(GLAD_GL_VERSION_4_4 != 0), frameSize(0), mapped(nullptr), fences(), frame(0), used(0), mapOffset(0), current(), stats()
+{
+    this->create(frameSize);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    this->destroy();
+}
+
+void StreamBuffer::create(size_t size)
+{
+    this->frameSize = size;
+    glGenBuffers(1, &this->ID);
+    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    if (this->persistent)
+    {
+        // one region per frame in flight, mapped for as long as the buffer lives
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size * STREAM_FRAMES, nullptr, flags);
+        this->mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size * STREAM_FRAMES, flags));
+        if (!this->mapped)
+        {
+            std::cout << "ERROR::STREAM_BUFFER: Failed to map the buffer persistently, orphaning it instead" << std::endl;
+            glDeleteBuffers(1, &this->ID);
+            this->persistent = false;
+            this->create(size);
+            return;
+        }
+    }
+    else // the driver hands out fresh storage each time the buffer is orphaned, so one region is enough
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    this->frame = 0;
+}
+
+void StreamBuffer::destroy()
+{
+    for (unsigned int i = 0; i < STREAM_FRAMES; ++i)
+        if (this->fences[i])
+        {
+            glDeleteSync(this->fences[i]);
+            this->fences[i] = 0;
+        }
+    if (this->persistent && this->mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    this->mapped = nullptr;
+    // the driver keeps the storage alive until draws still reading it are done
+    glDeleteBuffers(1, &this->ID);
+    this->ID = 0;
+}
+
+void StreamBuffer::Begin()
+{
+    this->current = StreamStats();
+    this->current.Capacity = this->frameSize;
+    this->used = 0;
+    if (!this->persistent)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+        glBufferData(GL_ARRAY_BUFFER, this->frameSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    GLsync& fence = this->fences[this->frame];
+    if (!fence)
+        return;
+    // usually the GPU finished with the region long ago; only measure when it hasn't
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        auto start = std::chrono::steady_clock::now();
+        do
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+        while (result == GL_TIMEOUT_EXPIRED);
+        this->current.WaitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (result == GL_WAIT_FAILED)
+        std::cout << "ERROR::STREAM_BUFFER: Waiting for the GPU failed" << std::endl;
+    glDeleteSync(fence);
+    fence = 0;
+}
+
+void* StreamBuffer::Map(size_t size, size_t alignment)
+{
+    size_t offset = (this->used + alignment - 1) / alignment * alignment;
+    if (offset + size > this->frameSize)
+    {
+        // make the region big enough for all of this frame's data; what was already drawn keeps the old buffer alive
+        size_t newSize = this->frameSize;
+        while (newSize < offset + size)
+            newSize *= 2;
+        this->destroy();
+        this->create(newSize);
+        this->current.Capacity = newSize;
+        this->current.Grew = true;
+        offset = 0;
+    }
+    this->used = offset + size;
+    this->current.Bytes += size;
+    ++this->current.Allocations;
+    if (this->persistent)
+    {
+        this->mapOffset = this->frame * this->frameSize + offset;
+        return this->mapped + this->mapOffset;
+    }
+    // the range was orphaned this frame and nothing else writes it, so there's nothing to wait for
+    this->mapOffset = offset;
+    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    this->mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    return this->mapped;
+}
+
+size_t StreamBuffer::Unmap()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+    if (!this->persistent)
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        this->mapped = nullptr;
+    }
+    return this->mapOffset;
+}
+
+void StreamBuffer::End()
+{
+    if (this->persistent)
+    {
+        this->fences[this->frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        this->frame = (this->frame + 1) % STREAM_FRAMES;
+    }
+    this->stats = this->current;
+}
\ No newline at end of file
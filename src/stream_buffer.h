@@ -0,0 +1,67 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+#include <cstddef>
+
+#include <glad/glad.h>
+
+
+// Number of frames the GPU may lag behind the CPU before Begin waits for it
+const unsigned int STREAM_FRAMES = 3;
+// Space reserved for each frame's dynamic vertex data up front (grows when a frame needs more)
+const size_t STREAM_FRAME_SIZE = 1 << 20;
+
+// Usage of the stream buffer during one frame
+struct StreamStats {
+    size_t       Bytes;       // handed out by Map
+    unsigned int Allocations; // number of Map calls
+    size_t       Capacity;    // of the frame's region
+    double       WaitTime;    // seconds spent waiting for the GPU to release the region
+    bool         Grew;        // the region was too small and the buffer was recreated larger
+};
+
+// StreamBuffer is one vertex buffer shared by everything that uploads vertex or instance
+// data every frame (sprite batches, text, particles). Each frame writes to its own region
+// of the buffer, and a frame's region is only reused once the GPU has finished the draws of
+// the frame that last used it (STREAM_FRAMES frames ago), so writing never stalls the driver.
+// Where the context supports it (GL 4.4) the buffer is mapped once, persistently; otherwise
+// each frame orphans the buffer and maps ranges of the fresh storage unsynchronized.
+//
+// Per frame: Begin, then any number of Map/Unmap pairs (draw from the buffer at the offset
+// Unmap returns), then End. The buffer's ID changes when it grows, so bind it after Unmap.
+class StreamBuffer
+{
+public:
+    // GL buffer name
+    unsigned int ID;
+    // constructor/destructor
+    StreamBuffer(size_t frameSize = STREAM_FRAME_SIZE);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+    // whether the buffer is persistently mapped (or orphaned every frame)
+    bool  Persistent() const { return this->persistent; }
+    // starts a frame: waits (if it has to) until the GPU no longer reads the frame's region
+    void  Begin();
+    // returns size bytes of the frame's region to write to (aligned to alignment)
+    void* Map(size_t size, size_t alignment = 16);
+    // finishes writing what Map returned; returns its offset in the buffer (leaves the buffer bound to GL_ARRAY_BUFFER)
+    size_t Unmap();
+    // ends the frame: fences its region
+    void  End();
+    // usage of the last frame that ended
+    const StreamStats& Stats() const { return this->stats; }
+private:
+    bool   persistent;
+    size_t frameSize;             // size of each region
+    unsigned char* mapped;        // whole buffer (persistent) or the current Map (orphaning)
+    GLsync fences[STREAM_FRAMES]; // of each region's last frame
+    unsigned int frame;           // region of the current frame
+    size_t used;                  // within the region
+    size_t mapOffset;             // offset of the current Map
+    StreamStats current, stats;
+    // (re)creates the buffer with regions of the given size
+    void create(size_t size);
+    void destroy();
+};
+
+#endif
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -8,21 +9,17 @@
 #include "Managers/resource_manager.h"
 
 
-TextRenderer::TextRenderer(unsigned int width, unsigned int height)
+TextRenderer::TextRenderer(unsigned int width, unsigned int height, StreamBuffer* stream)
+    : stream(stream)
 {
     // load and configure shader
     this->TextShader = ResourceManager::LoadShader("src/shaders/text.vs", "src/shaders/text.fs", nullptr, "text");
     this->TextShader.SetMatrix4("projection", glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f), true);
     this->TextShader.SetInteger("text", 0);
-    // configure VAO/VBO for texture quads
+    // configure VAO for texture quads (pointed into the stream buffer by RenderText)
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
     glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
@@ -89,44 +86,48 @@ void TextRenderer::Load(std::string font, unsigned int fontSize)
 
 void TextRenderer::RenderText(std::string text, float x, float y, float scale, glm::vec3 color)
 {
-    // activate corresponding render state	
-    this->TextShader.Use();
-    this->TextShader.SetVector3f("textColor", color);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++)
+    if (text.empty())
+        return;
+    // write the quads of all characters at once
+    float (*vertices)[6][4] = static_cast<float(*)[6][4]>(this->stream->Map(text.size() * sizeof(*vertices)));
+    float top = static_cast<float>(this->Characters['H'].Bearing.y);
+    for (size_t i = 0; i < text.size(); ++i)
     {
-        Character ch = Characters[*c];
+        const Character& ch = this->Characters[text[i]];
 
         float xpos = x + ch.Bearing.x * scale;
-        float ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+        float ypos = y + (top - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
+        float quad[6][4] = {
             { xpos,     ypos + h,   0.0f, 1.0f },
             { xpos + w, ypos,       1.0f, 0.0f },
             { xpos,     ypos,       0.0f, 0.0f },
 
             { xpos,     ypos + h,   0.0f, 1.0f },
             { xpos + w, ypos + h,   1.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 0.0f }    
+            { xpos + w, ypos,       1.0f, 0.0f }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // be sure to use glBufferSubData and not glBufferData
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        std::memcpy(vertices[i], quad, sizeof(quad));
         // now advance cursors for next glyph
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (1/64th times 2^6 = 64)
     }
+    size_t offset = this->stream->Unmap();
+
+    // activate corresponding render state
+    this->TextShader.Use();
+    this->TextShader.SetVector3f("textColor", color);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(this->VAO);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)offset);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // each glyph has a texture of its own, so draw them one by one
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        glBindTexture(GL_TEXTURE_2D, this->Characters[text[i]].TextureID);
+        glDrawArrays(GL_TRIANGLES, static_cast<GLint>(i * 6), 6);
+    }
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include "texture.h"
 #include "shader.h"
+#include "stream_buffer.h"
 
 
 /// Holds all state information relevant to a character as loaded using FreeType
@@ -29,15 +30,16 @@ public:
     std::map<char, Character> Characters;
     // shader used for text rendering
     Shader TextShader;
-    // constructor
-    TextRenderer(unsigned int width, unsigned int height);
+    // constructor; the glyph quads are written to stream
+    TextRenderer(unsigned int width, unsigned int height, StreamBuffer* stream);
     // pre-compiles a list of characters from the given font
     void Load(std::string font, unsigned int fontSize);
     // renders a string of text using the precompiled list of characters
     void RenderText(std::string text, float x, float y, float scale, glm::vec3 color = glm::vec3(1.0f));
 private:
     // render state
-    unsigned int VAO, VBO;
+    StreamBuffer* stream;
+    unsigned int VAO;
 };
 
 #endif 
\ No newline at end of file
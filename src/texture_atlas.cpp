@@ -0,0 +1,125 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "stb_image.h"
+
+
+TextureAtlas::TextureAtlas()
+{
+    this->Texture.Internal_Format = GL_RGBA;
+    this->Texture.Image_Format = GL_RGBA;
+    // the edges of the atlas hold images too; nothing should wrap around onto them
+    this->Texture.Wrap_S = GL_CLAMP_TO_EDGE;
+    this->Texture.Wrap_T = GL_CLAMP_TO_EDGE;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    if (this->Texture.ID != 0)
+        glDeleteTextures(1, &this->Texture.ID);
+}
+
+bool TextureAtlas::Add(const char* file, const std::string& name)
+{
+    int width, height, channels;
+    unsigned char* data = stbi_load(file, &width, &height, &channels, 4);
+    if (!data)
+    {
+        std::cout << "ERROR::ATLAS: Failed to load image " << file << std::endl;
+        return false;
+    }
+    Image image;
+    image.Name = name;
+    image.Width = width;
+    image.Height = height;
+    image.Pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    image.X = image.Y = 0;
+    stbi_image_free(data);
+    this->images.push_back(std::move(image));
+    return true;
+}
+
+bool TextureAtlas::pack(unsigned int width, unsigned int height, const std::vector<unsigned int>& order)
+{
+    unsigned int x = 0, y = 0, shelfHeight = 0;
+    for (unsigned int index : order)
+    {
+        Image& image = this->images[index];
+        unsigned int spanX = image.Width + 2 * ATLAS_PADDING, spanY = image.Height + 2 * ATLAS_PADDING;
+        if (x + spanX > width)
+        {   // start the next shelf
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (x + spanX > width || y + spanY > height)
+            return false;
+        image.X = x + ATLAS_PADDING;
+        image.Y = y + ATLAS_PADDING;
+        x += spanX;
+        shelfHeight = std::max(shelfHeight, spanY);
+    }
+    return true;
+}
+
+bool TextureAtlas::Build(unsigned int maxSize)
+{
+    // tallest first, so each shelf wastes little height
+    std::vector<unsigned int> order(this->images.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) { return this->images[a].Height > this->images[b].Height; });
+    // the smallest texture that fits them: 64x32, 64x64, 128x64, ...
+    unsigned int width = 64, height = 32;
+    while (!this->pack(width, height, order))
+    {
+        if (height < width)
+            height = width;
+        else
+            width *= 2, height = width / 2;
+        if (width > maxSize)
+        {
+            std::cout << "ERROR::ATLAS: Images don't fit in a " << maxSize << "x" << maxSize << " texture" << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4, 0);
+    for (Image& image : this->images)
+    {
+        // copy the image, repeating its edge pixels out into the padding
+        int left = static_cast<int>(image.X - ATLAS_PADDING), top = static_cast<int>(image.Y - ATLAS_PADDING);
+        for (unsigned int row = 0; row < image.Height + 2 * ATLAS_PADDING; ++row)
+        {
+            unsigned int sourceRow = std::min(static_cast<unsigned int>(std::max(static_cast<int>(row) - static_cast<int>(ATLAS_PADDING), 0)), image.Height - 1);
+            for (unsigned int column = 0; column < image.Width + 2 * ATLAS_PADDING; ++column)
+            {
+                unsigned int sourceColumn = std::min(static_cast<unsigned int>(std::max(static_cast<int>(column) - static_cast<int>(ATLAS_PADDING), 0)), image.Width - 1);
+                std::memcpy(&pixels[((static_cast<size_t>(top) + row) * width + left + column) * 4], &image.Pixels[(static_cast<size_t>(sourceRow) * image.Width + sourceColumn) * 4], 4);
+            }
+        }
+        Sprite sprite;
+        sprite.UV = glm::vec4(image.X, image.Y, image.Width, image.Height) / glm::vec4(width, height, width, height);
+        this->sprites[image.Name] = sprite;
+        std::vector<unsigned char>().swap(image.Pixels);
+    }
+    this->Texture.Generate(width, height, &pixels[0]);
+    for (auto& sprite : this->sprites)
+        sprite.second.Texture = this->Texture.ID;
+    return true;
+}
+
+Sprite TextureAtlas::Get(const std::string& name) const
+{
+    auto found = this->sprites.find(name);
+    if (found == this->sprites.end())
+    {
+        std::cout << "ERROR::ATLAS: No image named " << name << std::endl;
+        Sprite none = { this->Texture.ID, glm::vec4(0.0f) };
+        return none;
+    }
+    return found->second;
+}
\ No newline at end of file
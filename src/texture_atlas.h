@@ -0,0 +1,55 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "texture.h"
+
+
+// Sprite is the part of a texture an image takes up (the whole texture if it has one of its own)
+struct Sprite {
+    unsigned int Texture; // GL texture name
+    glm::vec4    UV;      // offset, size (in texture coordinates)
+};
+
+// Number of pixels kept free around each image of an atlas (filled with the image's
+// edge, so linear filtering never picks up a neighbour)
+const unsigned int ATLAS_PADDING = 2;
+
+// TextureAtlas packs many small images into one texture, so sprites that use them can
+// all be drawn without switching textures. Images are added by file, then Build packs
+// them (shelf by shelf, tallest first) into the smallest power of two texture they fit
+// in (twice as wide as high, or square).
+class TextureAtlas
+{
+public:
+    // the packed texture (valid after Build)
+    Texture2D Texture;
+    // constructor/destructor (the destructor deletes the texture)
+    TextureAtlas();
+    ~TextureAtlas();
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+    // loads an image to be packed under name; returns false (and reports why) if it can't be read
+    bool   Add(const char* file, const std::string& name);
+    // packs the images into the texture, no bigger than maxSize on a side; returns false if they don't fit
+    bool   Build(unsigned int maxSize = 4096);
+    // the sprite of an image (after Build)
+    Sprite Get(const std::string& name) const;
+private:
+    struct Image {
+        std::string                Name;
+        unsigned int               Width, Height;
+        std::vector<unsigned char> Pixels; // RGBA, row by row (freed once packed)
+        unsigned int               X, Y;   // where it was packed
+    };
+    std::vector<Image>            images;
+    std::map<std::string, Sprite> sprites;
+    // places the images on shelves in a width x height texture; returns false if they don't fit
+    bool pack(unsigned int width, unsigned int height, const std::vector<unsigned int>& order);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "wav_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+
+static std::uint32_t readU32(const unsigned char* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24); }
+static std::uint16_t readU16(const unsigned char* p) { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+
+// one sample of the given format, as a float in [-1, 1]
+static float readSample(const unsigned char* p, unsigned int format, unsigned int bits)
+{
+    if (format == 3)
+    {
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    switch (bits)
+    {
+    case 8:  return (p[0] - 128) / 128.0f;
+    case 16: return static_cast<std::int16_t>(readU16(p)) / 32768.0f;
+    case 24: return static_cast<std::int32_t>((p[0] << 8) | (p[1] << 16) | (static_cast<std::uint32_t>(p[2]) << 24)) / 2147483648.0f;
+    default: return static_cast<std::int32_t>(readU32(p)) / 2147483648.0f;
+    }
+}
+
+WavReader::WavReader()
+    : format(0), channels(0), rate(0), bits(0), frameSize(0), frames(0), position(0), dataOffset(0)
+{
+
+}
+
+bool WavReader::Open(const char* file)
+{
+    this->stream.open(file, std::ios::binary);
+    unsigned char header[12];
+    if (!this->stream.read(reinterpret_cast<char*>(header), sizeof(header)) || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0)
+    {
+        std::cout << "ERROR::AUDIO: Not a PCM .wav file: " << file << std::endl;
+        return false;
+    }
+    // walk the chunks up to the sample data, picking up the format on the way
+    unsigned char chunk[8];
+    while (this->stream.read(reinterpret_cast<char*>(chunk), sizeof(chunk)))
+    {
+        std::uint32_t size = readU32(chunk + 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+            std::vector<unsigned char> body(size);
+            this->stream.read(reinterpret_cast<char*>(&body[0]), size);
+            this->format = readU16(&body[0]);
+            this->channels = readU16(&body[2]);
+            this->rate = readU32(&body[4]);
+            this->bits = readU16(&body[14]);
+            if (this->format == 0xFFFE && size >= 26)
+                this->format = readU16(&body[24]); // WAVE_FORMAT_EXTENSIBLE: the real format is in the sub format
+        }
+        else if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            bool integer = this->format == 1 && (this->bits == 8 || this->bits == 16 || this->bits == 24 || this->bits == 32);
+            bool floating = this->format == 3 && this->bits == 32;
+            if ((!integer && !floating) || this->channels == 0 || this->rate == 0)
+                break;
+            this->frameSize = this->channels * this->bits / 8;
+            this->frames = size / this->frameSize;
+            this->dataOffset = this->stream.tellg();
+            this->position = 0;
+            return true;
+        }
+        else
+            this->stream.seekg(size, std::ios::cur);
+        if (size & 1)
+            this->stream.seekg(1, std::ios::cur); // chunks are padded to an even size
+    }
+    std::cout << "ERROR::AUDIO: Unsupported .wav format in " << file << std::endl;
+    return false;
+}
+
+unsigned int WavReader::Read(float* stereo, unsigned int count)
+{
+    count = std::min(count, this->frames - this->position);
+    this->raw.resize(static_cast<size_t>(count) * this->frameSize);
+    if (count == 0 || !this->stream.read(reinterpret_cast<char*>(&this->raw[0]), this->raw.size()))
+        return 0;
+    unsigned int bytes = this->bits / 8;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const unsigned char* frame = &this->raw[static_cast<size_t>(i) * this->frameSize];
+        for (unsigned int side = 0; side < 2; ++side)
+            stereo[i * 2 + side] = readSample(frame + std::min(side, this->channels - 1) * bytes, this->format, this->bits);
+    }
+    this->position += count;
+    return count;
+}
+
+void WavReader::Rewind()
+{
+    this->stream.clear();
+    this->stream.seekg(this->dataOffset);
+    this->position = 0;
+}
+
+bool LoadWav(const char* file, unsigned int rate, std::vector<float>& samples)
+{
+    WavReader reader;
+    if (!reader.Open(file))
+        return false;
+    std::vector<float> source(static_cast<size_t>(reader.Frames()) * 2);
+    unsigned int sourceFrames = source.empty() ? 0 : reader.Read(&source[0], reader.Frames());
+    if (sourceFrames == 0)
+    {
+        samples.clear();
+        return true;
+    }
+    // convert to the mixer's rate (linear interpolation between the source frames)
+    size_t frames = static_cast<size_t>(static_cast<double>(sourceFrames) * rate / reader.Rate());
+    samples.resize(frames * 2);
+    double step = static_cast<double>(reader.Rate()) / rate;
+    for (size_t i = 0; i < frames; ++i)
+    {
+        double position = i * step;
+        size_t index = static_cast<size_t>(position);
+        size_t next = std::min<size_t>(index + 1, sourceFrames - 1);
+        float t = static_cast<float>(position - index);
+        for (unsigned int side = 0; side < 2; ++side)
+            samples[i * 2 + side] = source[index * 2 + side] + (source[next * 2 + side] - source[index * 2 + side]) * t;
+    }
+    return true;
+}
+
+WavWriter::WavWriter(const char* file, unsigned int rate)
+    : file(std::fopen(file, "wb")), rate(rate), frames(0)
+{
+    if (!this->file)
+        std::cout << "ERROR::AUDIO: Could not create " << file << std::endl;
+    else
+        this->writeHeader(); // rewritten with the final sizes once done
+}
+
+WavWriter::~WavWriter()
+{
+    if (this->file)
+    {
+        std::fseek(this->file, 0, SEEK_SET);
+        this->writeHeader();
+        std::fclose(this->file);
+    }
+}
+
+void WavWriter::Write(const short* samples, unsigned int frames)
+{
+    if (!this->file)
+        return;
+    // the file is little endian, like every platform this builds on
+    std::fwrite(samples, sizeof(short) * 2, frames, this->file);
+    this->frames += frames;
+}
+
+void WavWriter::writeHeader()
+{
+    std::uint32_t dataSize = this->frames * 4;
+    unsigned char header[44];
+    auto put32 = [&header](unsigned int at, std::uint32_t value) {
+        for (unsigned int i = 0; i < 4; ++i)
+            header[at + i] = static_cast<unsigned char>(value >> (8 * i));
+    };
+    auto put16 = [&header](unsigned int at, std::uint16_t value) {
+        header[at] = static_cast<unsigned char>(value);
+        header[at + 1] = static_cast<unsigned char>(value >> 8);
+    };
+    std::memcpy(header, "RIFF", 4);
+    put32(4, 36 + dataSize);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    put32(16, 16);             // fmt chunk size
+    put16(20, 1);              // PCM
+    put16(22, 2);              // stereo
+    put32(24, this->rate);
+    put32(28, this->rate * 4); // bytes per second
+    put16(32, 4);              // bytes per frame
+    put16(34, 16);             // bits per sample
+    std::memcpy(header + 36, "data", 4);
+    put32(40, dataSize);
+    std::fwrite(header, 1, sizeof(header), this->file);
+}
\ No newline at end of file
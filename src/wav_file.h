@@ -0,0 +1,53 @@
+#ifndef WAV_FILE_H
+#define WAV_FILE_H
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "audio_backend.h"
+
+
+// WavReader reads the sample data of a PCM (8/16/24/32 bit integer or 32 bit float)
+// .wav file a piece at a time, at the file's own sample rate
+class WavReader
+{
+public:
+    WavReader();
+    // reads the header; returns false (and reports why) if the file isn't a supported .wav
+    bool         Open(const char* file);
+    unsigned int Rate() const { return this->rate; }
+    unsigned int Frames() const { return this->frames; }
+    // reads up to count frames as interleaved stereo floats (mono plays on both sides); returns
+    // how many were read, which is less than count only at the end of the file
+    unsigned int Read(float* stereo, unsigned int count);
+    // goes back to the first frame
+    void         Rewind();
+private:
+    std::ifstream              stream;
+    unsigned int               format, channels, rate, bits;
+    unsigned int               frameSize, frames, position;
+    std::streamoff             dataOffset;
+    std::vector<unsigned char> raw;
+};
+
+// Reads a PCM (8/16/24/32 bit integer or 32 bit float) .wav file, converted to interleaved
+// stereo floats at the given sample rate. Other formats (e.g. mp3) are reported and refused.
+bool LoadWav(const char* file, unsigned int rate, std::vector<float>& samples);
+
+// WavWriter is an AudioSink that stores everything it is given as a 16-bit stereo .wav file
+class WavWriter : public AudioSink
+{
+public:
+    // constructor/destructor; the file is complete once the writer is destroyed
+    WavWriter(const char* file, unsigned int rate);
+    ~WavWriter();
+    bool IsOpen() const { return this->file != nullptr; }
+    void Write(const short* samples, unsigned int frames);
+private:
+    std::FILE*   file;
+    unsigned int rate;
+    unsigned int frames; // written so far
+    void writeHeader();
+};
+
+#endif
\ No newline at end of file
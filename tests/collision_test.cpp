@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <vector>
+
+#include "collision.h"
+#include "random.h"
+
+// Checks that CheckCollisionBatch (SSE2/AVX where the build targets them) reports exactly what the
+// scalar CheckCollision does, box by box, on the cases where a vector kernel is most likely to differ.
+
+static unsigned int failures = 0;
+
+// runs the batch test from first and compares every box against the scalar test
+static void compare(const char* name, glm::vec2 center, float radius, CollisionBatch& batch, unsigned int first = 0)
+{
+    unsigned int hits = CheckCollisionBatch(center, radius, batch, first);
+    unsigned int expected = 0;
+    for (unsigned int i = first; i < batch.Count(); ++i)
+    {
+        Collision collision = CheckCollision(center, radius, glm::vec2(batch.X[i], batch.Y[i]), glm::vec2(batch.Width[i], batch.Height[i]));
+        if (!std::get<0>(collision))
+            continue;
+        if (expected >= hits || batch.Hits[expected].Index != i || batch.Hits[expected].Dir != std::get<1>(collision) ||
+            batch.Hits[expected].Difference != std::get<2>(collision))
+        {
+            if (failures++ < 20)
+                std::printf("FAIL %s: box %u (of %u, from %u) against circle (%g, %g) r %g\n", name, i, batch.Count(), first, center.x, center.y, radius);
+            return;
+        }
+        ++expected;
+    }
+    if (expected != hits && failures++ < 20)
+        std::printf("FAIL %s: %u hits, expected %u (%u boxes, from %u)\n", name, hits, expected, batch.Count(), first);
+}
+
+// a box of size 10x10 at the origin, tested against circles that only just touch it, sit inside it or sit
+// on its diagonals, in batches of every size around the lane counts (box i of the batch is the one under test)
+static void edgeCases()
+{
+    struct Case {
+        const char* Name;
+        glm::vec2   Center;
+        float       Radius;
+    };
+    const Case cases[] = {
+        { "distance equal to radius (right)",  glm::vec2(15.0f, 5.0f),  5.0f },
+        { "distance equal to radius (top)",    glm::vec2(5.0f, -4.0f),  4.0f },
+        { "distance equal to radius (corner)", glm::vec2(13.0f, 14.0f), 5.0f }, // 3-4-5 triangle
+        { "just inside radius",                glm::vec2(15.0f, 5.0f),  5.0001f },
+        { "zero difference (center inside)",   glm::vec2(5.0f, 5.0f),   1.0f },
+        { "zero difference (on the edge)",     glm::vec2(10.0f, 5.0f),  1.0f },
+        { "zero difference (on the corner)",   glm::vec2(0.0f, 0.0f),   1.0f },
+        { "direction tie (bottom right)",      glm::vec2(13.0f, 13.0f), 5.0f },
+        { "direction tie (bottom left)",       glm::vec2(-3.0f, 13.0f), 5.0f },
+        { "direction tie (top right)",         glm::vec2(13.0f, -3.0f), 5.0f },
+        { "direction tie (top left)",          glm::vec2(-3.0f, -3.0f), 5.0f },
+    };
+    CollisionBatch batch;
+    for (const Case& test : cases)
+    {
+        for (unsigned int size = 1; size <= 19; ++size)
+        {
+            for (unsigned int under = 0; under < size; ++under)
+            {
+                // the other boxes are hit or missed depending on their position, so every lane sees both
+                batch.Clear();
+                for (unsigned int i = 0; i < size; ++i)
+                {
+                    if (i == under)
+                        batch.Add(i, 0.0f, 0.0f, 10.0f, 10.0f);
+                    else
+                        batch.Add(i, (i % 3) * 10.0f - 10.0f, (i % 2) * 10.0f - 10.0f, 10.0f, 10.0f);
+                }
+                compare(test.Name, test.Center, test.Radius, batch);
+                compare(test.Name, test.Center, test.Radius, batch, under);
+            }
+        }
+    }
+    batch.Clear();
+    compare("empty batch", glm::vec2(0.0f), 1.0f, batch);
+}
+
+// random boxes and circles on a coarse grid, so exact touches, zero differences and ties come up often
+static void randomCases()
+{
+    Random random(DEFAULT_SEED, STREAM_GAMEPLAY);
+    CollisionBatch batch;
+    for (unsigned int round = 0; round < 20000; ++round)
+    {
+        unsigned int size = random.NextBelow(40);
+        batch.Clear();
+        for (unsigned int i = 0; i < size; ++i)
+            batch.Add(i, random.NextBelow(20) * 2.0f, random.NextBelow(20) * 2.0f, random.NextBelow(6) * 2.0f, random.NextBelow(6) * 2.0f);
+        glm::vec2 center(static_cast<float>(random.NextBelow(44)) - 2.0f, static_cast<float>(random.NextBelow(44)) - 2.0f);
+        float radius = 1.0f + random.NextBelow(8);
+        compare("random", center, radius, batch, size > 0 ? random.NextBelow(size) : 0);
+    }
+}
+
+int main()
+{
+    edgeCases();
+    randomCases();
+    if (failures > 0)
+    {
+        std::printf("%u failures\n", failures);
+        return 1;
+    }
+    std::printf("batch collisions match the scalar test\n");
+    return 0;
+}
\ No newline at end of file
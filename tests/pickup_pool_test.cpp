@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <vector>
+
+#include "power_up.h"
+#include "random.h"
+
+// Checks PickupPool's generational handles: a handle finds its pickup wherever Remove moves it, and
+// stops finding anything once the pickup is gone, even after its slot is reused by a new pickup.
+
+static unsigned int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition && failures++ < 20)
+        std::printf("FAIL %s\n", what);
+}
+
+// whether handle finds the pickup at x (each pickup of a test gets a distinct x)
+static bool finds(const PickupPool& pool, PickupHandle handle, float x)
+{
+    unsigned int i;
+    return pool.Find(handle, i) && i < pool.Count() && pool.X[i] == x;
+}
+
+// whether handle finds nothing at all
+static bool stale(const PickupPool& pool, PickupHandle handle)
+{
+    unsigned int i;
+    return !pool.Find(handle, i);
+}
+
+static void basics()
+{
+    PickupPool pool;
+    check(stale(pool, PickupHandle()), "a default handle finds nothing");
+    PickupHandle a = pool.Spawn(POWERUP_SPEED, glm::vec2(1.0f, 0.0f));
+    PickupHandle b = pool.Spawn(POWERUP_CHAOS, glm::vec2(2.0f, 0.0f));
+    PickupHandle c = pool.Spawn(POWERUP_SPLIT, glm::vec2(3.0f, 0.0f));
+    check(pool.Count() == 3 && finds(pool, a, 1.0f) && finds(pool, b, 2.0f) && finds(pool, c, 3.0f), "spawned pickups are found");
+    for (unsigned int i = 0; i < pool.Count(); ++i)
+    {
+        unsigned int found;
+        check(pool.Find(pool.Handle(i), found) && found == i, "Handle(i) finds index i");
+    }
+
+    // removing the first pickup moves the last one into its place
+    pool.Remove(0);
+    check(pool.Count() == 2, "remove shrinks the pool");
+    check(stale(pool, a), "a removed pickup's handle is stale");
+    check(finds(pool, c, 3.0f) && pool.Type[0] == POWERUP_SPLIT, "the moved pickup is still found");
+    check(finds(pool, b, 2.0f), "untouched pickups are still found");
+
+    // the freed slot is reused, but the old handle must not find the new pickup
+    PickupHandle d = pool.Spawn(POWERUP_STICKY, glm::vec2(4.0f, 0.0f));
+    check(d.Index == a.Index && d.Generation != a.Generation, "a freed slot is reused with a new generation");
+    check(finds(pool, d, 4.0f), "the reused slot's new handle is found");
+    check(stale(pool, a), "the old handle of a reused slot stays stale");
+
+    // removing the last pickup (nothing to move)
+    unsigned int last;
+    check(pool.Find(d, last) && last == pool.Count() - 1, "a new pickup is last");
+    pool.Remove(last);
+    check(stale(pool, d) && finds(pool, b, 2.0f) && finds(pool, c, 3.0f), "removing the last pickup");
+
+    // clearing retires every handle
+    pool.Clear();
+    check(pool.Count() == 0 && stale(pool, b) && stale(pool, c), "clear retires all handles");
+    PickupHandle e = pool.Spawn(POWERUP_CONFUSE, glm::vec2(5.0f, 0.0f));
+    check(finds(pool, e, 5.0f) && stale(pool, b) && stale(pool, c), "handles from before a clear stay stale");
+}
+
+static void capacity()
+{
+    PickupPool pool;
+    std::vector<PickupHandle> handles;
+    for (unsigned int i = 0; i < PickupPool::CAPACITY; ++i)
+        handles.push_back(pool.Spawn(POWERUP_SPEED, glm::vec2(static_cast<float>(i), 0.0f)));
+    PickupHandle overflow = pool.Spawn(POWERUP_SPEED, glm::vec2(-1.0f, 0.0f));
+    check(pool.Count() == PickupPool::CAPACITY && stale(pool, overflow), "spawning into a full pool is dropped");
+    bool all = true;
+    for (unsigned int i = 0; i < PickupPool::CAPACITY; ++i)
+        all = all && finds(pool, handles[i], static_cast<float>(i));
+    check(all, "a full pool finds all its pickups");
+}
+
+// random spawns and removes against a list of every handle ever handed out
+static void churn()
+{
+    struct Given {
+        PickupHandle Handle;
+        float        X;
+        bool         Live;
+    };
+    Random random(DEFAULT_SEED, STREAM_GAMEPLAY);
+    PickupPool pool;
+    std::vector<Given> given;
+    std::vector<unsigned int> live; // indices into given
+    for (unsigned int step = 0; step < 200000; ++step)
+    {
+        if (live.empty() || (live.size() < PickupPool::CAPACITY && random.NextBelow(2) == 0))
+        {
+            Given pickup = { pool.Spawn(POWERUP_SPEED, glm::vec2(static_cast<float>(step), 0.0f)), static_cast<float>(step), true };
+            live.push_back(static_cast<unsigned int>(given.size()));
+            given.push_back(pickup);
+        }
+        else
+        {
+            unsigned int which = random.NextBelow(static_cast<unsigned int>(live.size()));
+            Given& pickup = given[live[which]];
+            unsigned int i;
+            if (!pool.Find(pickup.Handle, i))
+            {
+                check(false, "churn: a live handle is found");
+                return;
+            }
+            pool.Remove(i);
+            pickup.Live = false;
+            live[which] = live.back();
+            live.pop_back();
+        }
+        if (step % 1000 == 0)
+        {
+            bool ok = pool.Count() == live.size();
+            // the most recent handles cover reused slots, stale and live ones alike
+            for (size_t g = given.size() > 4096 ? given.size() - 4096 : 0; g < given.size(); ++g)
+                ok = ok && (given[g].Live ? finds(pool, given[g].Handle, given[g].X) : stale(pool, given[g].Handle));
+            check(ok, "churn: live handles find their pickup and stale ones find nothing");
+        }
+    }
+}
+
+int main()
+{
+    basics();
+    capacity();
+    churn();
+    if (failures > 0)
+    {
+        std::printf("%u failures\n", failures);
+        return 1;
+    }
+    std::printf("pickup handles behave\n");
+    return 0;
+}
\ No newline at end of file